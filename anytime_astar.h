@@ -0,0 +1,215 @@
+#ifndef ANYTIME_ASTAR_H
+#define ANYTIME_ASTAR_H
+
+#include <bits/stdc++.h>
+#include "batch.h"
+#include "closed_set.h"
+#include "heuristics.h"
+#include "node_arena.h"
+#include "open_list.h"
+#include "packed_board.h"
+#include "search_budget.h"
+
+// Weights are held in tenths so that f = g + w * h stays an integer key for
+// the open lists: the key is WEIGHT_SCALE * g + weight * h.
+const int WEIGHT_SCALE = 10;
+const int DEFAULT_ANYTIME_WEIGHT = 3 * WEIGHT_SCALE;
+const int ANYTIME_WEIGHT_STEP = WEIGHT_SCALE / 2;
+
+// Accepts weights from 1 to 100, rounded to the nearest tenth.
+inline bool parseWeight(const std::string& text, int& weight) {
+    char* end;
+    double value = strtod(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0' || !(value >= 1 && value <= 100)) {
+        return false;
+    }
+    weight = (int)std::lround(value * WEIGHT_SCALE);
+    return true;
+}
+
+inline double weightValue(int weight) {
+    return (double)weight / WEIGHT_SCALE;
+}
+
+// Anytime repairing A* (ARA*, Likhachev, Gordon and Thrun 2003). A weighted
+// A* search on g + w * h finds a first solution quickly; w is then lowered
+// step by step and the search continues from where it stopped instead of
+// starting again. Nodes, g values and the open list are kept between
+// iterations. States improved after they were closed wait in an
+// inconsistent list, and only the closed set is emptied for each iteration.
+// States are never reopened within an iteration, which with a consistent
+// heuristic keeps each solution within the smaller of w and
+// g(goal) / min(g + h) over the open and inconsistent states of the
+// optimum. One object can be reused for many solves, keeping its memory.
+template <int N>
+class AnytimeAStar {
+public:
+    typedef std::function<void(const SolveResult&)> Improvement;
+
+    AnytimeAStar() : heuristic(nullptr) {}
+
+    // Runs until a solution is proven optimal or the budget runs out, and
+    // returns the best solution found, or the best partial path if there is
+    // none. improved, if given, sees every better solution as it is found.
+    // The caller must check solvability first.
+    SolveResult solve(const Heuristic<N>& towardsGoal, const PackedBoard<N>& start, const PackedBoard<N>& goal,
+                      int weight, const SearchBudget& budget, const Improvement& improved = Improvement()) {
+        heuristic = &towardsGoal;
+        reset(start, goal);
+        openList.push(0, weight * nodes[0].h, 0);
+        BudgetMonitor monitor(budget);
+        SolveResult result;
+        while (improvePath(weight, monitor, result.budgetLimit) && goalIndex != NO_PARENT) {
+            int nextWeight = std::max(WEIGHT_SCALE, weight - ANYTIME_WEIGHT_STEP);
+            int lowerBound = requeue(nextWeight);
+            double bound =
+                std::min(weightValue(weight), lowerBound > 0 ? (double)nodes[goalIndex].g / lowerBound : 1.0);
+            if (result.status != SOLVED || nodes[goalIndex].g < result.moveCount || bound < result.bound) {
+                result.status = SOLVED;
+                result.moveCount = nodes[goalIndex].g;
+                result.path = reconstructPath(nodes, goalIndex);
+                result.bound = std::max(1.0, bound);
+                result.expandedNodes = expandedNodes;
+                if (improved) {
+                    improved(result);
+                }
+            }
+            if (weight == WEIGHT_SCALE || result.bound <= 1) {
+                break;
+            }
+            weight = nextWeight;
+            closed.clear();
+        }
+
+        result.expandedNodes = expandedNodes;
+        if (result.status != SOLVED) {
+            result.status = BUDGET_EXCEEDED;
+            result.moveCount = nodes[closest].g;
+            result.path = reconstructPath(nodes, closest);
+            result.remainingEstimate = nodes[closest].h;
+        }
+        return result;
+    }
+
+private:
+    struct Node {
+        PackedBoard<N> board;
+        int g;
+        int h;
+        uint32_t parent;
+        int8_t parentBlank;
+        char move;
+    };
+
+    void reset(const PackedBoard<N>& start, const PackedBoard<N>& goal) {
+        target = goal;
+        openList.clear();
+        nodes.clear();
+        closed.clear();
+        bestNode.clear();
+        inconsistent.clear();
+        goalIndex = NO_PARENT;
+        closest = 0;
+        expandedNodes = 0;
+        insert(Node{start, 0, heuristic->evaluate(start), NO_PARENT, -1, 0});
+    }
+
+    uint32_t insert(const Node& node) {
+        uint32_t index = nodes.allocate(node);
+        bestNode.assign(node.board, index);
+        if (node.board == target) {
+            goalIndex = index;
+        }
+        return index;
+    }
+
+    uint32_t lookup(const PackedBoard<N>& board) const {
+        uint32_t index;
+        return bestNode.find(board, index) ? index : NO_PARENT;
+    }
+
+    size_t memoryBytes() const {
+        return nodes.memoryBytes() + openList.memoryBytes() + closed.memoryBytes() + bestNode.memoryBytes();
+    }
+
+    // Expands states in order of g + w * h until none is cheaper than the
+    // goal. Returns false if the budget ran out first.
+    bool improvePath(int weight, BudgetMonitor& monitor, BudgetLimit& limit) {
+        const MoveTable<N>& table = moveTable<N>();
+        while (!openList.empty()) {
+            if (goalIndex != NO_PARENT && WEIGHT_SCALE * nodes[goalIndex].g <= openList.topKey()) {
+                break;
+            }
+            uint32_t index = openList.pop();
+            const Node& current = nodes[index];
+            if (lookup(current.board) != index || !closed.insert(current.board)) {
+                continue;
+            }
+            expandedNodes++;
+            if (current.h < nodes[closest].h) {
+                closest = index;
+            }
+
+            int blank = current.board.blank;
+            for (int k = 0; k < table.count[blank]; ++k) {
+                int from = table.target[blank][k];
+                if (from == current.parentBlank) {
+                    continue;
+                }
+                PackedBoard<N> board = current.board.slide(from);
+                uint32_t known = lookup(board);
+                if (known != NO_PARENT && nodes[known].g <= current.g + 1) {
+                    continue;
+                }
+                int h = known != NO_PARENT
+                            ? nodes[known].h
+                            : heuristic->update(board, current.h, current.board.tileAt(from), from, blank);
+                uint32_t child = insert(Node{board, current.g + 1, h, index, (int8_t)blank, moveName<N>(blank, from)});
+                if (closed.contains(board)) {
+                    inconsistent.push_back(child);
+                } else {
+                    openList.push(child, WEIGHT_SCALE * (current.g + 1) + weight * h, current.g + 1);
+                }
+            }
+            if (monitor.exhausted(expandedNodes, [&] { return memoryBytes(); }, limit)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Moves the inconsistent states into the open list, drops entries that
+    // were superseded, keys everything for the next weight and returns the
+    // smallest g + h among them (0 if there is none).
+    int requeue(int weight) {
+        std::vector<uint32_t> pending;
+        pending.swap(inconsistent);
+        while (!openList.empty()) {
+            pending.push_back(openList.pop());
+        }
+        openList.clear();
+        int lowerBound = INT_MAX;
+        for (uint32_t index : pending) {
+            const Node& node = nodes[index];
+            if (lookup(node.board) != index) {
+                continue;
+            }
+            lowerBound = std::min(lowerBound, node.g + node.h);
+            openList.push(index, WEIGHT_SCALE * node.g + weight * node.h, node.g);
+        }
+        return lowerBound == INT_MAX ? 0 : lowerBound;
+    }
+
+    const Heuristic<N>* heuristic;
+    PackedBoard<N> target;
+    BucketOpenList openList;
+    NodeArena<Node> nodes;
+    ClosedSet<N> closed;
+    BestNodeMap<N> bestNode;
+    std::vector<uint32_t> inconsistent;
+    uint32_t goalIndex;
+    uint32_t closest;
+    long long expandedNodes;
+};
+
+#endif
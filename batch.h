@@ -0,0 +1,135 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <bits/stdc++.h>
+#include "closed_set.h"
+#include "node_arena.h"
+#include "packed_board.h"
+#include "search_budget.h"
+#include "search_stats.h"
+#include "thread_pool.h"
+
+enum SolveStatus {
+    SOLVED,
+    NOT_SOLVABLE,
+    BUDGET_EXCEEDED,
+    NO_SOLUTION
+};
+
+// A solution is at most bound times as long as an optimal one; only the
+// weighted searches report a bound above 1. When the budget runs out before
+// any solution, moveCount and path describe the best partial path instead:
+// the one to the expanded state with the lowest heuristic, which is still
+// remainingEstimate moves from the goal by that heuristic.
+struct SolveResult {
+    SolveStatus status = NO_SOLUTION;
+    int moveCount = 0;
+    std::string path;
+    long long expandedNodes = 0;
+    double seconds = 0;
+    double bound = 1;
+    BudgetLimit budgetLimit = NODE_BUDGET;
+    int remainingEstimate = 0;
+    SearchStats stats;
+};
+
+// Everything a best-first search allocates. Kept alive between solves and
+// cleared, not freed, so later searches reuse the memory of earlier ones.
+template <int N, class Node, class OpenList>
+struct SearchWorkspace {
+    OpenList openList;
+    NodeArena<Node> nodes;
+    ClosedSet<N> visited;
+
+    void clear() {
+        openList.clear();
+        nodes.clear();
+        visited.clear();
+    }
+
+    size_t memoryBytes() const {
+        return openList.memoryBytes() + nodes.memoryBytes() + visited.memoryBytes();
+    }
+};
+
+template <int N>
+struct BatchInstance {
+    PackedBoard<N> initial;
+    PackedBoard<N> goal;
+};
+
+template <int N>
+bool isValidBoard(const std::vector<int>& cells, size_t first) {
+    std::vector<bool> seen(N * N, false);
+    for (size_t i = first; i < first + N * N; ++i) {
+        if (cells[i] < 0 || cells[i] >= N * N || seen[cells[i]]) {
+            return false;
+        }
+        seen[cells[i]] = true;
+    }
+    return true;
+}
+
+// Reads instances in the interactive input format, the initial state and then
+// the goal state, N * N numbers each, repeated until the end of the stream.
+// On failure, returns false and describes the problem in error.
+template <int N>
+bool readBatch(std::istream& in, std::vector<BatchInstance<N>>& instances, std::string& error) {
+    std::vector<int> numbers;
+    int value;
+    while (in >> value) {
+        numbers.push_back(value);
+    }
+    if (!in.eof()) {
+        error = "expected only numbers after value " + std::to_string(numbers.size());
+        return false;
+    }
+    const size_t perInstance = 2 * N * N;
+    if (numbers.empty() || numbers.size() % perInstance != 0) {
+        error = "every instance needs " + std::to_string(perInstance) + " numbers";
+        return false;
+    }
+
+    instances.clear();
+    for (size_t first = 0; first < numbers.size(); first += perInstance) {
+        if (!isValidBoard<N>(numbers, first) || !isValidBoard<N>(numbers, first + N * N)) {
+            error = "instance " + std::to_string(instances.size() + 1) + " is not a permutation of 0 to " +
+                    std::to_string(N * N - 1);
+            return false;
+        }
+        BatchInstance<N> instance = {{0, 0}, {0, 0}};
+        for (int pos = 0; pos < N * N; ++pos) {
+            instance.initial.setTile(pos, numbers[first + pos]);
+            instance.goal.setTile(pos, numbers[first + N * N + pos]);
+            if (numbers[first + pos] == 0) {
+                instance.initial.blank = pos;
+            }
+            if (numbers[first + N * N + pos] == 0) {
+                instance.goal.blank = pos;
+            }
+        }
+        instances.push_back(instance);
+    }
+    return true;
+}
+
+// Solves every instance with solve(instance, workspace) on a work-stealing
+// pool and returns the results in input order. Each worker thread creates
+// its own Workspace on first use and keeps it for all its later solves.
+template <class Workspace, class Instance, class Solve>
+std::vector<SolveResult> solveBatch(const std::vector<Instance>& instances, int threads, Solve solve) {
+    std::vector<SolveResult> results(instances.size());
+    WorkStealingPool pool(threads);
+    std::vector<std::unique_ptr<Workspace>> workspaces(pool.threads());
+    pool.run(instances.size(), [&](size_t index, int worker) {
+        if (!workspaces[worker]) {
+            workspaces[worker].reset(new Workspace());
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        results[index] = solve(instances[index], *workspaces[worker]);
+        results[index].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    });
+    return results;
+}
+
+#endif
@@ -0,0 +1,329 @@
+#include <bits/stdc++.h>
+#include "batch.h"
+#include "generator.h"
+#include "packed_board.h"
+#include "pattern_database.h"
+#include "solver.h"
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+const int DEFAULT_PER_DEPTH = 10;
+const char* const SOLVER_NAMES[] = {"manhattan@star", "misp@star", "greddy-best-MAnhatten", "greddy-best-Misp"};
+const int SOLVER_COUNT = 4;
+
+template <int N>
+struct BenchmarkInstance {
+    PackedBoard<N> initial;
+    PackedBoard<N> goal;
+    int optimal;
+};
+
+// Largest resident set size of the process so far, in kilobytes.
+long peakResidentKilobytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return (long)(counters.PeakWorkingSetSize / 1024);
+#else
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return atol(line.c_str() + 6);
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#endif
+}
+
+// Lets the next solver's peak be measured on its own where the kernel
+// supports it (Linux 4.0 and later); elsewhere the peak only ever grows.
+void resetPeakResident() {
+#ifndef _WIN32
+    ofstream clear("/proc/self/clear_refs");
+    clear << "5" << flush;
+#endif
+}
+
+// Every 3x3 state that can reach goal, found by breadth-first search from
+// the goal, and perDepth of them drawn at random from each distance.
+vector<BenchmarkInstance<3>> randomEightPuzzles(const PackedBoard<3>& goal, int perDepth, mt19937_64& rng) {
+    vector<int8_t> distance(362880, -1);
+    vector<vector<PackedBoard<3>>> byDepth(1, vector<PackedBoard<3>>(1, goal));
+    distance[permutationRank(goal)] = 0;
+    const MoveTable<3>& table = moveTable<3>();
+    for (int depth = 0; !byDepth[depth].empty(); ++depth) {
+        byDepth.push_back({});
+        for (const PackedBoard<3>& board : byDepth[depth]) {
+            for (int k = 0; k < table.count[board.blank]; ++k) {
+                PackedBoard<3> next = board.slide(table.target[board.blank][k]);
+                uint64_t rank = permutationRank(next);
+                if (distance[rank] < 0) {
+                    distance[rank] = depth + 1;
+                    byDepth[depth + 1].push_back(next);
+                }
+            }
+        }
+    }
+
+    vector<BenchmarkInstance<3>> instances;
+    for (size_t depth = 0; depth < byDepth.size(); ++depth) {
+        vector<PackedBoard<3>>& states = byDepth[depth];
+        size_t take = min(states.size(), (size_t)perDepth);
+        for (size_t i = 0; i < take; ++i) {
+            swap(states[i], states[i + randomBelow(rng, states.size() - i)]);
+            instances.push_back(BenchmarkInstance<3>{states[i], goal, (int)depth});
+        }
+    }
+    return instances;
+}
+
+// The configuration each solver program runs with by default.
+SolverConfig solverConfig(int solver) {
+    SolverConfig config;
+    config.algorithm = solver < 2 ? ASTAR_SEARCH : GREEDY_SEARCH;
+    config.heuristic = solver % 2 == 0 ? MANHATTAN_DISTANCE : MISPLACED_TILES;
+    return config;
+}
+
+// Nearest-rank percentile of sorted values.
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = (size_t)ceil(p / 100 * sorted.size());
+    return sorted[max<size_t>(rank, 1) - 1];
+}
+
+void writeBenchmarkHeader(ostream& out) {
+    out << "corpus,solver,instances,solved,expanded,nodes_per_second,time_p50_ms,time_p90_ms,time_p99_ms,time_max_ms,"
+           "peak_rss_kb,optimal_known,mean_gap_moves,max_gap_moves,optimal_solutions\n";
+}
+
+// Fills in the optimum of every instance that has none with IDA*, which
+// needs memory only for the solution depth: on the additive pattern database
+// if one is given, otherwise on linear conflict. Both are admissible, so the
+// lengths found are optimal. The node and time budget applies, and an
+// instance that runs out of it keeps an unknown optimum.
+template <int N>
+void findOptima(vector<BenchmarkInstance<N>>& instances, const PatternDatabase<N>* database,
+                const SearchBudget& budget) {
+    SolverConfig config;
+    config.algorithm = IDA_STAR_SEARCH;
+    config.heuristic = database != nullptr ? PATTERN_DATABASE : LINEAR_CONFLICT;
+    config.budget = budget;
+    Solver<N> reference(config, database);
+    SolverContext<N> context;
+    for (BenchmarkInstance<N>& instance : instances) {
+        if (instance.optimal < 0) {
+            SolveResult result = reference.solve(instance.initial, instance.goal, context);
+            if (result.status == SOLVED) {
+                instance.optimal = result.moveCount;
+            }
+        }
+    }
+}
+
+// Runs the selected solvers one after another over the corpus, on one
+// thread so that times are comparable, and writes one CSV row per solver.
+// Optima that are not known yet are found afterwards with findOptima, so
+// that its pattern database does not count towards any solver's peak.
+template <int N>
+void runBenchmark(const string& corpus, vector<BenchmarkInstance<N>> instances, const vector<bool>& selected,
+                  const SearchBudget& budget, const PatternDatabase<N>* database, ostream& out) {
+    vector<vector<SolveResult>> results(SOLVER_COUNT);
+    vector<long> peaks(SOLVER_COUNT, 0);
+    for (int solver = 0; solver < SOLVER_COUNT; ++solver) {
+        if (!selected[solver]) {
+            continue;
+        }
+        resetPeakResident();
+        SolverConfig config = solverConfig(solver);
+        config.budget = budget;
+        Solver<N> search(config);
+        unique_ptr<SolverContext<N>> context(new SolverContext<N>());
+        for (const BenchmarkInstance<N>& instance : instances) {
+            results[solver].push_back(search.solve(instance.initial, instance.goal, *context));
+        }
+        peaks[solver] = peakResidentKilobytes();
+        cerr << corpus << ": " << SOLVER_NAMES[solver] << " done" << endl;
+    }
+    findOptima<N>(instances, database, budget);
+
+    for (int solver = 0; solver < SOLVER_COUNT; ++solver) {
+        if (!selected[solver]) {
+            continue;
+        }
+        int solved = 0, known = 0, optimalSolutions = 0, maxGap = 0;
+        long long expanded = 0, totalGap = 0;
+        double seconds = 0;
+        vector<double> times;
+        for (size_t i = 0; i < instances.size(); ++i) {
+            const SolveResult& result = results[solver][i];
+            expanded += result.expandedNodes;
+            seconds += result.seconds;
+            times.push_back(result.seconds * 1000);
+            if (result.status != SOLVED) {
+                continue;
+            }
+            solved++;
+            if (instances[i].optimal >= 0) {
+                int gap = result.moveCount - instances[i].optimal;
+                known++;
+                totalGap += gap;
+                maxGap = max(maxGap, gap);
+                optimalSolutions += gap == 0;
+            }
+        }
+        sort(times.begin(), times.end());
+        out << fixed << setprecision(3) << corpus << "," << SOLVER_NAMES[solver] << "," << instances.size() << ","
+            << solved << "," << expanded << "," << (seconds > 0 ? expanded / seconds : 0) << ","
+            << percentile(times, 50) << "," << percentile(times, 90) << "," << percentile(times, 99) << ","
+            << percentile(times, 100) << "," << peaks[solver] << "," << known << ","
+            << (known > 0 ? (double)totalGap / known : 0) << "," << maxGap << "," << optimalSolutions << "\n";
+    }
+    out.flush();
+}
+
+template <int N>
+bool loadCorpus(const string& path, vector<BenchmarkInstance<N>>& instances) {
+    ifstream file(path);
+    if (!file) {
+        cout << "Cannot read " << path << endl;
+        return false;
+    }
+    vector<BatchInstance<N>> batch;
+    string error;
+    if (!readBatch<N>(file, batch, error)) {
+        cout << "Cannot read " << path << ": " << error << endl;
+        return false;
+    }
+    for (const BatchInstance<N>& instance : batch) {
+        if (permutationParity(instance.initial) != permutationParity(instance.goal)) {
+            cout << path << " contains an instance that cannot be solved." << endl;
+            return false;
+        }
+        instances.push_back(BenchmarkInstance<N>{instance.initial, instance.goal, -1});
+    }
+    return true;
+}
+
+template <int N>
+int benchmarkCorpus(const string& path, const string& databasePath, const vector<bool>& selected,
+                    const SearchBudget& budget, ostream& out) {
+    vector<BenchmarkInstance<N>> instances;
+    if (!loadCorpus<N>(path, instances)) {
+        return 1;
+    }
+    PatternDatabase<N> database;
+    if (!databasePath.empty()) {
+        string error;
+        if (!database.open(databasePath, error)) {
+            cout << "Cannot use pattern database: " << error << endl;
+            return 1;
+        }
+        for (const BenchmarkInstance<N>& instance : instances) {
+            if (database.builtForGoal() != instance.goal) {
+                cout << "The pattern database was built for a different goal state than " << path << " uses." << endl;
+                return 1;
+            }
+        }
+    }
+    runBenchmark<N>(path, instances, selected, budget, databasePath.empty() ? nullptr : &database, out);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int size = 4;
+    int perDepth = DEFAULT_PER_DEPTH;
+    SearchBudget budget;
+    uint64_t seed = DEFAULT_SEED;
+    string corpus, solvers, output, databasePath;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--corpus" && i + 1 < argc) {
+            corpus = argv[++i];
+        } else if (arg == "--pdb" && i + 1 < argc) {
+            databasePath = argv[++i];
+        } else if (arg == "--size" && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (arg == "--per-depth" && i + 1 < argc) {
+            perDepth = atoi(argv[++i]);
+        } else if (arg == "--solvers" && i + 1 < argc) {
+            solvers = argv[++i];
+        } else if (arg == "--max-nodes" && i + 1 < argc) {
+            budget.maxNodes = max(0LL, atoll(argv[++i]));
+        } else if (arg == "--time-limit" && i + 1 < argc) {
+            budget.seconds = max(0.0, atof(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            cout << "Usage: benchmark [--per-depth K] [--corpus FILE --size 3|4|5 [--pdb FILE]]" << endl
+                 << "                 [--solvers a,b,...] [--max-nodes K] [--time-limit S] [--seed S]" << endl
+                 << "                 [--output FILE]" << endl
+                 << "Runs the solvers over K random 3x3 instances at every optimal distance (0 skips them)" << endl
+                 << "and over an optional corpus in batch format, such as Korf's 100 15-puzzle instances," << endl
+                 << "and writes one CSV row per corpus and solver. Solvers: manhattan@star, misp@star," << endl
+                 << "greddy-best-MAnhatten, greddy-best-Misp (default all). Corpus optima are found with" << endl
+                 << "IDA* on the pattern database from pdb-builder if --pdb is given, otherwise on linear" << endl
+                 << "conflict, under the same budget." << endl;
+            return 1;
+        }
+    }
+
+    vector<bool> selected(SOLVER_COUNT, solvers.empty());
+    stringstream names(solvers);
+    string name;
+    while (getline(names, name, ',')) {
+        const char* const* found = find(SOLVER_NAMES, SOLVER_NAMES + SOLVER_COUNT, name);
+        if (found == SOLVER_NAMES + SOLVER_COUNT) {
+            cout << "Unknown solver " << name << endl;
+            return 1;
+        }
+        selected[found - SOLVER_NAMES] = true;
+    }
+
+    ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file) {
+            cout << "Cannot write " << output << endl;
+            return 1;
+        }
+    }
+    ostream& out = output.empty() ? cout : file;
+    writeBenchmarkHeader(out);
+
+    if (perDepth > 0) {
+        mt19937_64 rng(seed);
+        PackedBoard<3> goal = packBoard<3>({{1, 2, 3}, {4, 5, 6}, {7, 8, 0}});
+        runBenchmark<3>("random-3x3", randomEightPuzzles(goal, perDepth, rng), selected, budget, nullptr, out);
+    }
+    if (corpus.empty()) {
+        return 0;
+    }
+    switch (size) {
+    case 3:
+        return benchmarkCorpus<3>(corpus, databasePath, selected, budget, out);
+    case 4:
+        return benchmarkCorpus<4>(corpus, databasePath, selected, budget, out);
+    case 5:
+        return benchmarkCorpus<5>(corpus, databasePath, selected, budget, out);
+    default:
+        cout << "Unsupported board size " << size << " (expected 3, 4 or 5)." << endl;
+        return 1;
+    }
+}
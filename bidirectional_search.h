@@ -0,0 +1,272 @@
+#ifndef BIDIRECTIONAL_SEARCH_H
+#define BIDIRECTIONAL_SEARCH_H
+
+#include <bits/stdc++.h>
+#include "closed_set.h"
+#include "heuristics.h"
+#include "node_arena.h"
+#include "open_list.h"
+#include "packed_board.h"
+#include "search_budget.h"
+#include "search_stats.h"
+
+// When the budget runs out, moveCount and path lead from the start to the
+// forward state with the lowest heuristic, remainingEstimate moves from the
+// goal by that heuristic.
+struct BidirectionalResult {
+    bool solved;
+    bool budgetExceeded;
+    int moveCount;
+    std::string path;
+    long long expandedNodes;
+    BudgetLimit budgetLimit;
+    int remainingEstimate;
+    SearchStats stats;
+};
+
+// Opposite blank move, for turning the backward half of a path around.
+inline char reverseMove(char move) {
+    switch (move) {
+    case 'U':
+        return 'D';
+    case 'D':
+        return 'U';
+    case 'L':
+        return 'R';
+    default:
+        return 'L';
+    }
+}
+
+// Bidirectional "meet in the middle" search (MM, Holte et al. 2016). One
+// search runs forward from the start with a heuristic towards the goal,
+// the other backward from the goal with a heuristic towards the start;
+// moves are reversible, so the backward search uses the same successors.
+// Each side orders its open list on max(f, 2g), which keeps both searches
+// from going past the midpoint of an optimal path, and the side whose best
+// priority is lower is expanded next.
+//
+// Every generated state is looked up on the other side; a hit gives a
+// complete path and so an upper bound U. With unit move costs, U is optimal
+// once it is at most the lower bound max(C, gminF + gminB + 1), where C is
+// the smaller of the two best priorities and gmin the smallest open g on
+// each side. Expansions on both sides count against the node budget.
+template <int N>
+class BidirectionalSearch {
+public:
+    BidirectionalSearch(const Heuristic<N>& towardsGoal, const Heuristic<N>& towardsStart)
+        : forward(towardsGoal), backward(towardsStart) {}
+
+    // The caller must check solvability first.
+    BidirectionalResult solve(const PackedBoard<N>& start, const PackedBoard<N>& goal,
+                              const SearchBudget& budget = SearchBudget()) {
+        BidirectionalResult result = {true, false, 0, "", 0, NODE_BUDGET, 0, SearchStats()};
+        if (start == goal) {
+            return result;
+        }
+        forward.reset(start);
+        backward.reset(goal);
+        bestCost = INT_MAX;
+        stats = SearchStats();
+        BudgetMonitor monitor(budget);
+
+        while (!forward.openList.empty() || !backward.openList.empty()) {
+            int forwardPriority = forward.minPriority();
+            int backwardPriority = backward.minPriority();
+            int lowerBound = std::max(std::min(forwardPriority, backwardPriority),
+                                      forward.minDepth() + backward.minDepth() + 1);
+            if (bestCost <= lowerBound) {
+                break;
+            }
+            bool expandForward =
+                forwardPriority < backwardPriority ||
+                (forwardPriority == backwardPriority && forward.openList.size() <= backward.openList.size());
+            if (expandForward) {
+                expand(forward, backward, true);
+            } else {
+                expand(backward, forward, false);
+            }
+            if (monitor.exhausted(forward.expandedNodes + backward.expandedNodes,
+                                  [&] { return forward.memoryBytes() + backward.memoryBytes(); }, result.budgetLimit)) {
+                result.budgetExceeded = true;
+                break;
+            }
+        }
+
+        result.solved = bestCost != INT_MAX && !result.budgetExceeded;
+        result.expandedNodes = forward.expandedNodes + backward.expandedNodes;
+        result.stats = stats;
+        if (result.budgetExceeded) {
+            result.moveCount = forward.nodes[forward.closest].g;
+            result.path = reconstructPath(forward.nodes, forward.closest);
+            result.remainingEstimate = forward.nodes[forward.closest].h;
+        } else if (result.solved) {
+            result.moveCount = bestCost;
+            result.path = reconstructPath(forward.nodes, forwardMeeting);
+            std::string back = reconstructPath(backward.nodes, backwardMeeting);
+            for (size_t i = back.size(); i-- > 0;) {
+                result.path += reverseMove(back[i]);
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Node {
+        PackedBoard<N> board;
+        int g;
+        int h;
+        uint32_t parent;
+        int8_t parentBlank;
+        char move;
+    };
+
+    // One direction of the search. bestNode maps every state generated on
+    // this side to the node with its lowest g; open list entries for nodes
+    // that were improved on later are skipped when popped. Those stale
+    // entries may make minPriority and minDepth a little low, which only
+    // makes the stopping test more cautious. closest is the node with the
+    // lowest heuristic generated on this side.
+    struct Side {
+        explicit Side(const Heuristic<N>& estimate) : heuristic(estimate) {}
+
+        void reset(const PackedBoard<N>& root) {
+            openList.clear();
+            nodes.clear();
+            bestNode.clear();
+            openAtDepth.assign(1, 0);
+            lowestDepth = 0;
+            expandedNodes = 0;
+            closest = 0;
+            insert(Node{root, 0, heuristic.evaluate(root), NO_PARENT, -1, 0});
+        }
+
+        void insert(const Node& node) {
+            uint32_t index = nodes.allocate(node);
+            bestNode.assign(node.board, index);
+            openList.push(index, std::max(node.g + node.h, 2 * node.g), node.g);
+            if (node.g >= (int)openAtDepth.size()) {
+                openAtDepth.resize(node.g + 1, 0);
+            }
+            openAtDepth[node.g]++;
+            lowestDepth = std::min(lowestDepth, node.g);
+            if (node.h < nodes[closest].h) {
+                closest = index;
+            }
+        }
+
+        // Returns the g of the cheapest known path to board, or -1.
+        int depthOf(const PackedBoard<N>& board, uint32_t& index) const {
+            if (!bestNode.find(board, index)) {
+                return -1;
+            }
+            return nodes[index].g;
+        }
+
+        int minPriority() {
+            return openList.empty() ? INT_MAX / 2 : openList.topKey();
+        }
+
+        int minDepth() {
+            while (lowestDepth < (int)openAtDepth.size() && openAtDepth[lowestDepth] == 0) {
+                lowestDepth++;
+            }
+            return lowestDepth < (int)openAtDepth.size() ? lowestDepth : INT_MAX / 4;
+        }
+
+        size_t memoryBytes() const {
+            return nodes.memoryBytes() + openList.memoryBytes() + bestNode.memoryBytes() +
+                   openAtDepth.capacity() * sizeof(long long);
+        }
+
+        const Heuristic<N>& heuristic;
+        BucketOpenList openList;
+        NodeArena<Node> nodes;
+        BestNodeMap<N> bestNode;
+        std::vector<long long> openAtDepth;
+        int lowestDepth;
+        long long expandedNodes;
+        uint32_t closest;
+    };
+
+    void expand(Side& side, Side& other, bool isForward) {
+        uint32_t index;
+        {
+            STATS_TIME(stats, QUEUE_PHASE);
+            index = side.openList.pop();
+        }
+        const Node& current = side.nodes[index];
+        side.openAtDepth[current.g]--;
+        uint32_t known = NO_PARENT;
+        bool stale;
+        {
+            STATS_TIME(stats, CLOSED_SET_PHASE);
+            stale = side.depthOf(current.board, known) < 0 || known != index;
+        }
+        if (stale) {
+            return;
+        }
+        side.expandedNodes++;
+
+        const MoveTable<N>& table = moveTable<N>();
+        int blank = current.board.blank;
+        for (int k = 0; k < table.count[blank]; ++k) {
+            int from = table.target[blank][k];
+            if (from == current.parentBlank) {
+                continue;
+            }
+            int tile = current.board.tileAt(from);
+            Node child;
+            child.board = current.board.slide(from);
+            child.g = current.g + 1;
+            STATS_COUNT(stats, generated, 1);
+            int depth;
+            {
+                STATS_TIME(stats, CLOSED_SET_PHASE);
+                depth = side.depthOf(child.board, known);
+            }
+            if (depth >= 0 && depth <= child.g) {
+                STATS_COUNT(stats, duplicates, 1);
+                continue;
+            }
+            if (depth >= 0) {
+                STATS_COUNT(stats, reopened, 1);
+            }
+            {
+                STATS_TIME(stats, HEURISTIC_PHASE);
+                child.h = side.heuristic.update(child.board, current.h, tile, from, blank);
+            }
+            child.parent = index;
+            child.parentBlank = (int8_t)blank;
+            child.move = moveName<N>(blank, from);
+            {
+                STATS_TIME(stats, QUEUE_PHASE);
+                side.insert(child);
+            }
+            STATS_PEAK(stats, peakOpen, side.openList.size() + other.openList.size());
+            STATS_PEAK(stats, peakClosed, side.bestNode.size() + other.bestNode.size());
+
+            uint32_t meeting;
+            int otherDepth;
+            {
+                STATS_TIME(stats, CLOSED_SET_PHASE);
+                otherDepth = other.depthOf(child.board, meeting);
+            }
+            if (otherDepth >= 0 && child.g + otherDepth < bestCost) {
+                bestCost = child.g + otherDepth;
+                uint32_t here = side.nodes.size() - 1;
+                forwardMeeting = isForward ? here : meeting;
+                backwardMeeting = isForward ? meeting : here;
+            }
+        }
+    }
+
+    Side forward;
+    Side backward;
+    int bestCost;
+    SearchStats stats;
+    uint32_t forwardMeeting;
+    uint32_t backwardMeeting;
+};
+
+#endif
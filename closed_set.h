@@ -0,0 +1,253 @@
+#ifndef CLOSED_SET_H
+#define CLOSED_SET_H
+
+#include <bits/stdc++.h>
+#include "packed_board.h"
+
+// Lehmer code of the tile permutation: a perfect hash into [0, (N*N)!).
+template <int N>
+uint64_t permutationRank(const PackedBoard<N>& board) {
+    static_assert(N <= 4, "(N*N)! must fit in 64 bits");
+    uint64_t rank = 0;
+    uint32_t used = 0;
+    for (int pos = 0; pos < N * N; ++pos) {
+        int tile = board.tileAt(pos);
+        int smallerUnused = tile - __builtin_popcount(used & ((1u << tile) - 1));
+        rank = rank * (N * N - pos) + smallerUnused;
+        used |= 1u << tile;
+    }
+    return rank;
+}
+
+inline uint64_t mixHash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+inline uint64_t mixHash(unsigned __int128 key) {
+    return mixHash((uint64_t)key ^ mixHash((uint64_t)(key >> 64)));
+}
+
+// One bit per permutation rank; only practical while (N*N)! is small.
+template <int N>
+class RankedClosedSet {
+public:
+    RankedClosedSet() : bits(0), count(0) {}
+
+    // Returns true if the board was not in the set yet.
+    bool insert(const PackedBoard<N>& board) {
+        if (bits.empty()) {
+            bits.assign((slotCount() + 63) / 64, 0);
+        }
+        uint64_t rank = permutationRank(board);
+        uint64_t mask = 1ULL << (rank & 63);
+        uint64_t& word = bits[rank >> 6];
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+        count++;
+        return true;
+    }
+
+    bool contains(const PackedBoard<N>& board) const {
+        if (bits.empty()) {
+            return false;
+        }
+        uint64_t rank = permutationRank(board);
+        return (bits[rank >> 6] >> (rank & 63)) & 1;
+    }
+
+    void clear() {
+        std::fill(bits.begin(), bits.end(), 0);
+        count = 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t memoryBytes() const {
+        return bits.size() * sizeof(uint64_t);
+    }
+
+private:
+    static uint64_t slotCount() {
+        uint64_t slots = 1;
+        for (int i = 2; i <= N * N; ++i) {
+            slots *= i;
+        }
+        return slots;
+    }
+
+    std::vector<uint64_t> bits;
+    size_t count;
+};
+
+// Open addressing with linear probing on the packed tiles word. No valid
+// board packs to all ones, so that value marks an empty slot.
+template <int N>
+class HashedClosedSet {
+public:
+    typedef typename PackedBoard<N>::Word Word;
+
+    HashedClosedSet() : slots(1024, EMPTY), count(0) {}
+
+    bool insert(const PackedBoard<N>& board) {
+        if ((count + 1) * 10 > slots.size() * 7) {
+            grow();
+        }
+        size_t mask = slots.size() - 1;
+        size_t i = mixHash(board.tiles) & mask;
+        while (slots[i] != EMPTY) {
+            if (slots[i] == board.tiles) {
+                return false;
+            }
+            i = (i + 1) & mask;
+        }
+        slots[i] = board.tiles;
+        count++;
+        return true;
+    }
+
+    bool contains(const PackedBoard<N>& board) const {
+        size_t mask = slots.size() - 1;
+        size_t i = mixHash(board.tiles) & mask;
+        while (slots[i] != EMPTY) {
+            if (slots[i] == board.tiles) {
+                return true;
+            }
+            i = (i + 1) & mask;
+        }
+        return false;
+    }
+
+    void clear() {
+        std::fill(slots.begin(), slots.end(), EMPTY);
+        count = 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t memoryBytes() const {
+        return slots.size() * sizeof(Word);
+    }
+
+private:
+    static constexpr Word EMPTY = ~Word(0);
+
+    void grow() {
+        std::vector<Word> old;
+        old.swap(slots);
+        slots.assign(old.size() * 2, EMPTY);
+        size_t mask = slots.size() - 1;
+        for (Word key : old) {
+            if (key != EMPTY) {
+                size_t i = mixHash(key) & mask;
+                while (slots[i] != EMPTY) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = key;
+            }
+        }
+    }
+
+    std::vector<Word> slots;
+    size_t count;
+};
+
+// Maps each state a search has generated to the index of the node that
+// reaches it with the lowest g, for searches that keep every generated state
+// rather than only the closed ones. Probing and the empty marker are as in
+// HashedClosedSet; keys and indices are kept apart so that neither pads the
+// other.
+template <int N>
+class BestNodeMap {
+public:
+    typedef typename PackedBoard<N>::Word Word;
+
+    BestNodeMap() : keys(1024, EMPTY), indices(1024), count(0) {}
+
+    // Returns false if board has no node yet.
+    bool find(const PackedBoard<N>& board, uint32_t& index) const {
+        size_t mask = keys.size() - 1;
+        size_t i = mixHash(board.tiles) & mask;
+        while (keys[i] != EMPTY) {
+            if (keys[i] == board.tiles) {
+                index = indices[i];
+                return true;
+            }
+            i = (i + 1) & mask;
+        }
+        return false;
+    }
+
+    // Makes index the node for board, replacing any earlier one.
+    void assign(const PackedBoard<N>& board, uint32_t index) {
+        if ((count + 1) * 10 > keys.size() * 7) {
+            grow();
+        }
+        size_t mask = keys.size() - 1;
+        size_t i = mixHash(board.tiles) & mask;
+        while (keys[i] != EMPTY && keys[i] != board.tiles) {
+            i = (i + 1) & mask;
+        }
+        if (keys[i] == EMPTY) {
+            keys[i] = board.tiles;
+            count++;
+        }
+        indices[i] = index;
+    }
+
+    void clear() {
+        std::fill(keys.begin(), keys.end(), EMPTY);
+        count = 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t memoryBytes() const {
+        return keys.size() * (sizeof(Word) + sizeof(uint32_t));
+    }
+
+private:
+    static constexpr Word EMPTY = ~Word(0);
+
+    void grow() {
+        std::vector<Word> oldKeys;
+        std::vector<uint32_t> oldIndices;
+        oldKeys.swap(keys);
+        oldIndices.swap(indices);
+        keys.assign(oldKeys.size() * 2, EMPTY);
+        indices.assign(oldKeys.size() * 2, 0);
+        size_t mask = keys.size() - 1;
+        for (size_t j = 0; j < oldKeys.size(); ++j) {
+            if (oldKeys[j] != EMPTY) {
+                size_t i = mixHash(oldKeys[j]) & mask;
+                while (keys[i] != EMPTY) {
+                    i = (i + 1) & mask;
+                }
+                keys[i] = oldKeys[j];
+                indices[i] = oldIndices[j];
+            }
+        }
+    }
+
+    std::vector<Word> keys;
+    std::vector<uint32_t> indices;
+    size_t count;
+};
+
+// The 3x3 permutation space fits in a 45 KB bitset; larger boards hash.
+template <int N>
+using ClosedSet = typename std::conditional<N <= 3, RankedClosedSet<N>, HashedClosedSet<N>>::type;
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef DISTANCE_TABLE_H
+#define DISTANCE_TABLE_H
+
+#include <bits/stdc++.h>
+#include "batch.h"
+#include "packed_board.h"
+
+// Exact distance to the goal of every 3x3 board that can reach it, one byte
+// each, found by breadth-first search from the goal. A board is reachable
+// when the order of its tiles 1 to 8, read around the blank, has the goal's
+// parity. Among those orders the Lehmer digit of the seventh tile, the only
+// one weighted 1, follows from the other digits, so the blank's cell and half
+// the order's rank are a perfect hash onto [0, 9!/2).
+//
+// Each table is built for the goal with tiles 1 to 8 in reading order around
+// the blank at goalBlank. Any other goal with its blank there is the same
+// goal under a renaming of the tiles; see relabelForTable.
+class EightPuzzleTable {
+public:
+    static constexpr int STATES = 181440;
+
+    explicit EightPuzzleTable(int goalBlank) : target(canonicalGoal(goalBlank)), distances(STATES, UNKNOWN) {
+        const MoveTable<3>& table = moveTable<3>();
+        std::vector<PackedBoard<3>> layer(1, target);
+        distances[index(target)] = 0;
+        for (int depth = 1; !layer.empty(); ++depth) {
+            std::vector<PackedBoard<3>> next;
+            for (const PackedBoard<3>& board : layer) {
+                for (int k = 0; k < table.count[board.blank]; ++k) {
+                    PackedBoard<3> neighbour = board.slide(table.target[board.blank][k]);
+                    uint8_t& known = distances[index(neighbour)];
+                    if (known == UNKNOWN) {
+                        known = (uint8_t)depth;
+                        next.push_back(neighbour);
+                    }
+                }
+            }
+            layer.swap(next);
+        }
+    }
+
+    static PackedBoard<3> canonicalGoal(int goalBlank) {
+        PackedBoard<3> goal = {0, goalBlank};
+        for (int pos = 0, tile = 1; pos < 9; ++pos) {
+            if (pos != goalBlank) {
+                goal.setTile(pos, tile++);
+            }
+        }
+        return goal;
+    }
+
+    const PackedBoard<3>& goal() const {
+        return target;
+    }
+
+    // board must have the goal's parity.
+    int distance(const PackedBoard<3>& board) const {
+        return distances[index(board)];
+    }
+
+    size_t memoryBytes() const {
+        return distances.size();
+    }
+
+private:
+    static constexpr uint8_t UNKNOWN = 0xff;
+
+    static uint32_t index(const PackedBoard<3>& board) {
+        uint32_t rank = 0;
+        uint32_t used = 0;
+        for (int pos = 0, placed = 0; pos < 9; ++pos) {
+            int tile = board.tileAt(pos);
+            if (tile != 0) {
+                rank = rank * (8 - placed++) + tile - 1 - __builtin_popcount(used & ((1u << tile) - 1));
+                used |= 1u << tile;
+            }
+        }
+        return board.blank * (STATES / 9) + (rank >> 1);
+    }
+
+    PackedBoard<3> target;
+    std::vector<uint8_t> distances;
+};
+
+// Built on first use, one per goal blank cell, and shared by every thread.
+inline const EightPuzzleTable& eightPuzzleTable(int goalBlank) {
+    static std::mutex lock;
+    static std::unique_ptr<EightPuzzleTable> tables[9];
+    std::lock_guard<std::mutex> guard(lock);
+    if (!tables[goalBlank]) {
+        tables[goalBlank].reset(new EightPuzzleTable(goalBlank));
+    }
+    return *tables[goalBlank];
+}
+
+// Renames the tiles of board so that goal becomes the table's goal. The
+// blank keeps its name and every cell its position, so a move sequence
+// solves the renamed board exactly when it solves the original.
+inline PackedBoard<3> relabelForTable(const PackedBoard<3>& board, const PackedBoard<3>& goal,
+                                      const EightPuzzleTable& table) {
+    int rename[9];
+    for (int pos = 0; pos < 9; ++pos) {
+        rename[goal.tileAt(pos)] = table.goal().tileAt(pos);
+    }
+    PackedBoard<3> renamed = board;
+    for (int pos = 0; pos < 9; ++pos) {
+        renamed.setTile(pos, rename[board.tileAt(pos)]);
+    }
+    return renamed;
+}
+
+// Only 3x3 boards have tables; checkSolverConfig keeps other sizes away.
+template <int N>
+SolveResult solveFromTable(const PackedBoard<N>&, const PackedBoard<N>&) {
+    return SolveResult();
+}
+
+// An optimal solution without searching: from start, some neighbour is
+// always one move closer to the goal, so the path is read off the table one
+// step at a time. Nothing is expanded. start must be able to reach goal.
+inline SolveResult solveFromTable(const PackedBoard<3>& start, const PackedBoard<3>& goal) {
+    const EightPuzzleTable& table = eightPuzzleTable(goal.blank);
+    const MoveTable<3>& moves = moveTable<3>();
+    PackedBoard<3> board = relabelForTable(start, goal, table);
+    int remaining = table.distance(board);
+    SolveResult result;
+    result.status = SOLVED;
+    result.moveCount = remaining;
+    while (remaining > 0) {
+        for (int k = 0; k < moves.count[board.blank]; ++k) {
+            int from = moves.target[board.blank][k];
+            PackedBoard<3> next = board.slide(from);
+            if (table.distance(next) == remaining - 1) {
+                result.path += moveName<3>(board.blank, from);
+                board = next;
+                break;
+            }
+        }
+        remaining--;
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,547 @@
+#ifndef EXTERNAL_SEARCH_H
+#define EXTERNAL_SEARCH_H
+
+#include <bits/stdc++.h>
+#include "batch.h"
+#include "heuristics.h"
+#include "packed_board.h"
+#include "search_budget.h"
+#include "search_stats.h"
+
+inline int seekFile(std::FILE* file, int64_t offset, int origin) {
+#ifdef _WIN32
+    return _fseeki64(file, offset, origin);
+#else
+    return fseeko(file, (off_t)offset, origin);
+#endif
+}
+
+inline int64_t tellFile(std::FILE* file) {
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return (int64_t)ftello(file);
+#endif
+}
+
+// Reads a file of fixed-size records front to back, one buffer at a time.
+template <class Record>
+class RecordReader {
+public:
+    RecordReader(const std::string& path, size_t bufferRecords)
+        : file(std::fopen(path.c_str(), "rb")), buffer(new Record[bufferRecords]), capacity(bufferRecords), next(0),
+          filled(0) {}
+
+    RecordReader(const RecordReader&) = delete;
+    RecordReader& operator=(const RecordReader&) = delete;
+
+    ~RecordReader() {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    bool good() const {
+        return file != nullptr;
+    }
+
+    // Returns false at the end of the file.
+    bool read(Record& record) {
+        if (next == filled) {
+            filled = file != nullptr ? std::fread(buffer.get(), sizeof(Record), capacity, file) : 0;
+            next = 0;
+            if (filled == 0) {
+                return false;
+            }
+        }
+        record = buffer[next++];
+        return true;
+    }
+
+private:
+    std::FILE* file;
+    // Left uninitialised: a layer's buffers are large and mostly unused.
+    std::unique_ptr<Record[]> buffer;
+    size_t capacity;
+    size_t next;
+    size_t filled;
+};
+
+// Appends fixed-size records to a new file, one buffer at a time.
+template <class Record>
+class RecordWriter {
+public:
+    RecordWriter(const std::string& path, size_t bufferRecords)
+        : file(std::fopen(path.c_str(), "wb")), failed(file == nullptr), written(0) {
+        buffer.reserve(bufferRecords);
+    }
+
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    ~RecordWriter() {
+        close();
+    }
+
+    void write(const Record& record) {
+        buffer.push_back(record);
+        written++;
+        if (buffer.size() == buffer.capacity()) {
+            flush();
+        }
+    }
+
+    // Returns false if any record could not be written.
+    bool close() {
+        if (file != nullptr) {
+            flush();
+            if (std::fclose(file) != 0) {
+                failed = true;
+            }
+            file = nullptr;
+        }
+        return !failed;
+    }
+
+    uint64_t size() const {
+        return written;
+    }
+
+private:
+    void flush() {
+        if (file != nullptr && !buffer.empty() &&
+            std::fwrite(buffer.data(), sizeof(Record), buffer.size(), file) != buffer.size()) {
+            failed = true;
+        }
+        buffer.clear();
+    }
+
+    std::FILE* file;
+    std::vector<Record> buffer;
+    bool failed;
+    uint64_t written;
+};
+
+// Binary search in a sorted file of records.
+template <class Record>
+bool sortedFileContains(const std::string& path, const Record& key) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    seekFile(file, 0, SEEK_END);
+    int64_t low = 0, high = tellFile(file) / (int64_t)sizeof(Record);
+    bool found = false;
+    while (low < high) {
+        int64_t middle = low + (high - low) / 2;
+        Record record;
+        if (seekFile(file, middle * (int64_t)sizeof(Record), SEEK_SET) != 0 ||
+            std::fread(&record, sizeof(Record), 1, file) != 1) {
+            break;
+        }
+        if (record == key) {
+            found = true;
+            break;
+        }
+        if (record < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    std::fclose(file);
+    return found;
+}
+
+// Breadth-first iterative-deepening A* (Zhou and Hansen 2004) with its
+// layers on disk, for instances whose frontier does not fit in memory. Each
+// iteration searches breadth first from the start, pruning states with
+// g + h above the bound, and the next iteration raises the bound to the
+// smallest pruned g + h, so the first solution found is optimal.
+//
+// Layers are files of sorted, distinct tile words. The children of a layer
+// are collected in memory, scored with Heuristic::evaluateMany, and spilled
+// as sorted runs whenever the buffer reaches half the RAM cap; the runs are
+// then merged into the next layer. The sliding-tile graph is bipartite, so a
+// child is either new or already in the layer before its parent's, and the
+// merge drops those by reading that layer alongside. Layers are kept until
+// the iteration ends and the path is recovered backwards through them, one
+// binary search per move. Disk use is about the size of all layers of the
+// last iteration.
+template <int N>
+class ExternalSearch {
+public:
+    typedef typename PackedBoard<N>::Word Word;
+
+    // Scratch files go in a new directory under scratchRoot, removed again
+    // after each solve.
+    ExternalSearch(const Heuristic<N>& estimate, const std::string& scratchRoot)
+        : heuristic(estimate), directory(scratchRoot) {}
+
+    // The caller must check solvability first. memoryBytes in the budget is
+    // the RAM cap for buffers rather than a limit on the search; the node
+    // and time budgets stop it as usual. Reports NO_SOLUTION if the scratch
+    // files cannot be written.
+    SolveResult solve(const PackedBoard<N>& start, const PackedBoard<N>& goal, const SearchBudget& budget) {
+        SolveResult result;
+        target = goal;
+        memoryCap = budget.memoryBytes > 0 ? budget.memoryBytes : DEFAULT_MEMORY_BUDGET_MB << 20;
+        expandedNodes = 0;
+        failed = false;
+        if (!createScratch()) {
+            return result;
+        }
+
+        BudgetMonitor monitor(budget);
+        int startHeuristic = heuristic.evaluate(start);
+        int bound = startHeuristic;
+        LayerOutcome outcome = NEXT_LAYER;
+        while (true) {
+            nextBound = INT_MAX;
+            closestHeuristic = startHeuristic;
+            closestDepth = 0;
+            closestTiles = start.tiles;
+            if (!writeLayer(std::vector<Word>(1, start.tiles))) {
+                break;
+            }
+            if (start == goal) {
+                outcome = GOAL_FOUND;
+                foundDepth = 0;
+                break;
+            }
+            outcome = NEXT_LAYER;
+            for (int depth = 0; outcome == NEXT_LAYER; ++depth) {
+                outcome = expandLayer(depth, bound, monitor, result, result.budgetLimit);
+            }
+            if (outcome != LAYER_EMPTY || nextBound == INT_MAX) {
+                break;
+            }
+            bound = nextBound;
+            removeLayers();
+        }
+
+        result.expandedNodes = expandedNodes;
+        if (outcome == GOAL_FOUND) {
+            result.status = SOLVED;
+            result.moveCount = foundDepth;
+            result.path = recoverPath(goal.tiles, foundDepth);
+        } else if (outcome == BUDGET_SPENT) {
+            result.status = BUDGET_EXCEEDED;
+            result.moveCount = closestDepth;
+            result.path = recoverPath(closestTiles, closestDepth);
+            result.remainingEstimate = closestHeuristic;
+        }
+        if (failed) {
+            result.status = NO_SOLUTION;
+        }
+        removeLayers();
+        std::error_code ignored;
+        std::filesystem::remove_all(scratch, ignored);
+        return result;
+    }
+
+private:
+    enum LayerOutcome {
+        NEXT_LAYER,
+        LAYER_EMPTY,
+        GOAL_FOUND,
+        BUDGET_SPENT,
+        WRITE_FAILED
+    };
+
+    // Successors are scored this many at a time.
+    static constexpr size_t SCORE_CHUNK = 4096;
+    // At most this many runs are merged at once, to stay clear of open file
+    // limits; more are first merged into longer runs.
+    static constexpr size_t MERGE_FAN_IN = 64;
+    static constexpr size_t MAX_BLOCK_BYTES = 1 << 20;
+
+    bool createScratch() {
+        static std::atomic<unsigned> counter(0);
+        std::filesystem::path base =
+            directory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(directory);
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            std::string stamp = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+            std::filesystem::path candidate = base / ("puzzle-search-" + stamp + "-" + std::to_string(counter++));
+            std::error_code error;
+            if (std::filesystem::create_directory(candidate, error)) {
+                scratch = candidate.string();
+                return true;
+            }
+            if (error) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    std::string scratchFile(const std::string& name) const {
+        return (std::filesystem::path(scratch) / name).string();
+    }
+
+    // Records per buffer when streams files are open at once, out of a
+    // quarter of the RAM cap.
+    size_t blockRecords(size_t streams) const {
+        size_t bytes = std::min(MAX_BLOCK_BYTES, memoryCap / 4 / std::max<size_t>(streams, 1));
+        return std::max<size_t>(bytes / sizeof(Word), 1024);
+    }
+
+    static PackedBoard<N> boardFromTiles(Word tiles) {
+        PackedBoard<N> board = {tiles, 0};
+        while (board.tileAt(board.blank) != 0) {
+            board.blank++;
+        }
+        return board;
+    }
+
+    bool writeLayer(const std::vector<Word>& sorted) {
+        std::string path = scratchFile("layer-" + std::to_string(layers.size()));
+        RecordWriter<Word> out(path, blockRecords(1));
+        for (Word tiles : sorted) {
+            out.write(tiles);
+        }
+        layers.push_back(path);
+        failed = failed || !out.close();
+        return !failed;
+    }
+
+    void removeLayers() {
+        for (const std::string& path : layers) {
+            std::remove(path.c_str());
+        }
+        layers.clear();
+    }
+
+    LayerOutcome expandLayer(int depth, int bound, BudgetMonitor& monitor, SolveResult& result, BudgetLimit& limit) {
+        const MoveTable<N>& table = moveTable<N>();
+        RecordReader<Word> in(layers[depth], blockRecords(1));
+        if (!in.good()) {
+            failed = true;
+            return WRITE_FAILED;
+        }
+        children.clear();
+        runs.clear();
+        runBuffer.clear();
+        Word tiles;
+        while (in.read(tiles)) {
+            PackedBoard<N> board = boardFromTiles(tiles);
+            expandedNodes++;
+            for (int k = 0; k < table.count[board.blank]; ++k) {
+                children.push_back(board.slide(table.target[board.blank][k]).tiles);
+            }
+            if (children.size() >= SCORE_CHUNK && scoreChildren(depth + 1, bound)) {
+                return GOAL_FOUND;
+            }
+            if (failed) {
+                return WRITE_FAILED;
+            }
+            if (monitor.exhausted(expandedNodes, [] { return (size_t)0; }, limit)) {
+                return BUDGET_SPENT;
+            }
+        }
+        if (scoreChildren(depth + 1, bound)) {
+            return GOAL_FOUND;
+        }
+        uint64_t size = mergeLayer(depth + 1);
+        STATS_PEAK(result.stats, peakOpen, size);
+        if (failed) {
+            return WRITE_FAILED;
+        }
+        return size == 0 ? LAYER_EMPTY : NEXT_LAYER;
+    }
+
+    // Scores the pending children, keeps those within the bound and returns
+    // true if one of them is the goal.
+    bool scoreChildren(int depth, int bound) {
+        scores.resize(children.size());
+        heuristic.evaluateMany(children.data(), children.size(), scores.data());
+        size_t runLimit = std::max<size_t>(memoryCap / 2 / sizeof(Word), SCORE_CHUNK);
+        for (size_t i = 0; i < children.size(); ++i) {
+            int f = depth + scores[i];
+            if (f > bound) {
+                nextBound = std::min(nextBound, f);
+                continue;
+            }
+            if (children[i] == target.tiles) {
+                foundDepth = depth;
+                return true;
+            }
+            if (scores[i] < closestHeuristic) {
+                closestHeuristic = scores[i];
+                closestDepth = depth;
+                closestTiles = children[i];
+            }
+            if (runBuffer.size() == runBuffer.capacity()) {
+                runBuffer.reserve(std::min(runLimit, std::max<size_t>(2 * runBuffer.capacity(), SCORE_CHUNK)));
+            }
+            runBuffer.push_back(children[i]);
+            if (runBuffer.size() >= runLimit) {
+                spillRun();
+            }
+        }
+        children.clear();
+        return false;
+    }
+
+    void sortRunBuffer() {
+        std::sort(runBuffer.begin(), runBuffer.end());
+        runBuffer.erase(std::unique(runBuffer.begin(), runBuffer.end()), runBuffer.end());
+    }
+
+    void spillRun() {
+        sortRunBuffer();
+        std::string path = scratchFile("run-" + std::to_string(runs.size()));
+        RecordWriter<Word> out(path, blockRecords(1));
+        for (Word tiles : runBuffer) {
+            out.write(tiles);
+        }
+        failed = failed || !out.close();
+        runs.push_back(path);
+        runBuffer.clear();
+    }
+
+    // Merges sorted runs into out, dropping repeats and anything in the
+    // sorted file skip (if not empty).
+    void mergeRuns(const std::vector<std::string>& sources, const std::string& skip, RecordWriter<Word>& out) {
+        size_t block = blockRecords(sources.size() + 2);
+        std::vector<std::unique_ptr<RecordReader<Word>>> readers;
+        typedef std::pair<Word, size_t> Head;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        for (const std::string& path : sources) {
+            readers.emplace_back(new RecordReader<Word>(path, block));
+            Word tiles;
+            if (!readers.back()->good()) {
+                failed = true;
+            } else if (readers.back()->read(tiles)) {
+                heads.push(Head(tiles, readers.size() - 1));
+            }
+        }
+        std::unique_ptr<RecordReader<Word>> skipped;
+        Word skipTiles = 0;
+        bool skipMore = false;
+        if (!skip.empty()) {
+            skipped.reset(new RecordReader<Word>(skip, block));
+            skipMore = skipped->read(skipTiles);
+        }
+        bool any = false;
+        Word last = 0;
+        while (!heads.empty()) {
+            Head head = heads.top();
+            heads.pop();
+            Word tiles;
+            if (readers[head.second]->read(tiles)) {
+                heads.push(Head(tiles, head.second));
+            }
+            if (any && head.first == last) {
+                continue;
+            }
+            any = true;
+            last = head.first;
+            while (skipMore && skipTiles < head.first) {
+                skipMore = skipped->read(skipTiles);
+            }
+            if (!skipMore || skipTiles != head.first) {
+                out.write(head.first);
+            }
+        }
+    }
+
+    // Writes the next layer from the runs and the buffer and returns its size.
+    uint64_t mergeLayer(int depth) {
+        std::string skip = depth >= 2 ? layers[depth - 2] : std::string();
+        std::string path = scratchFile("layer-" + std::to_string(depth));
+        if (runs.empty()) {
+            // Everything fitted in memory: subtract the older layer directly.
+            sortRunBuffer();
+            RecordWriter<Word> out(path, blockRecords(2));
+            std::unique_ptr<RecordReader<Word>> older;
+            Word skipTiles = 0;
+            bool skipMore = false;
+            if (!skip.empty()) {
+                older.reset(new RecordReader<Word>(skip, blockRecords(2)));
+                skipMore = older->read(skipTiles);
+            }
+            for (Word tiles : runBuffer) {
+                while (skipMore && skipTiles < tiles) {
+                    skipMore = older->read(skipTiles);
+                }
+                if (!skipMore || skipTiles != tiles) {
+                    out.write(tiles);
+                }
+            }
+            runBuffer.clear();
+            layers.push_back(path);
+            failed = failed || !out.close();
+            return out.size();
+        }
+
+        if (!runBuffer.empty()) {
+            spillRun();
+        }
+        // The buffer is empty from here on, so readers may use its half of
+        // the cap too.
+        std::vector<Word>().swap(runBuffer);
+        size_t merged = 0;
+        while (runs.size() > MERGE_FAN_IN) {
+            std::vector<std::string> group(runs.begin(), runs.begin() + MERGE_FAN_IN);
+            std::string longer = scratchFile("merged-" + std::to_string(merged++));
+            RecordWriter<Word> out(longer, blockRecords(MERGE_FAN_IN + 2));
+            mergeRuns(group, std::string(), out);
+            failed = failed || !out.close();
+            for (const std::string& run : group) {
+                std::remove(run.c_str());
+            }
+            runs.erase(runs.begin(), runs.begin() + MERGE_FAN_IN);
+            runs.push_back(longer);
+        }
+        RecordWriter<Word> out(path, blockRecords(runs.size() + 2));
+        mergeRuns(runs, skip, out);
+        layers.push_back(path);
+        failed = failed || !out.close();
+        for (const std::string& run : runs) {
+            std::remove(run.c_str());
+        }
+        runs.clear();
+        return out.size();
+    }
+
+    // Walks back from tiles at depth through the kept layers: some
+    // neighbour is always in the layer above.
+    std::string recoverPath(Word tiles, int depth) const {
+        const MoveTable<N>& table = moveTable<N>();
+        PackedBoard<N> board = boardFromTiles(tiles);
+        std::string path;
+        for (int d = depth - 1; d >= 0; --d) {
+            for (int k = 0; k < table.count[board.blank]; ++k) {
+                PackedBoard<N> previous = board.slide(table.target[board.blank][k]);
+                if (sortedFileContains(layers[d], previous.tiles)) {
+                    path += moveName<N>(previous.blank, board.blank);
+                    board = previous;
+                    break;
+                }
+            }
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    const Heuristic<N>& heuristic;
+    std::string directory;
+    std::string scratch;
+    PackedBoard<N> target;
+    size_t memoryCap = 0;
+    long long expandedNodes = 0;
+    bool failed = false;
+    int nextBound = INT_MAX;
+    int foundDepth = 0;
+    int closestHeuristic = 0;
+    int closestDepth = 0;
+    Word closestTiles = 0;
+    std::vector<std::string> layers;
+    std::vector<std::string> runs;
+    std::vector<Word> children;
+    std::vector<int> scores;
+    std::vector<Word> runBuffer;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <bits/stdc++.h>
+#include "packed_board.h"
+
+const uint64_t DEFAULT_SEED = 20240601;
+
+// Uniform integer in [0, bound) without the bias of a plain modulo.
+inline uint64_t randomBelow(std::mt19937_64& rng, uint64_t bound) {
+    uint64_t limit = UINT64_MAX - UINT64_MAX % bound;
+    uint64_t value;
+    do {
+        value = rng();
+    } while (value >= limit);
+    return value % bound;
+}
+
+// Uniformly random board that can reach goal. Swapping two numbered tiles
+// flips the permutation parity without moving the blank, so fixing the parity
+// of a uniform shuffle that way maps the unreachable half one-to-one onto the
+// reachable half and keeps the result uniform; nothing is rejected.
+template <int N>
+PackedBoard<N> randomSolvableBoard(std::mt19937_64& rng, const PackedBoard<N>& goal) {
+    int cells[N * N];
+    for (int pos = 0; pos < N * N; ++pos) {
+        cells[pos] = pos;
+    }
+    for (int i = N * N - 1; i > 0; --i) {
+        std::swap(cells[i], cells[randomBelow(rng, i + 1)]);
+    }
+
+    PackedBoard<N> board = {0, 0};
+    for (int pos = 0; pos < N * N; ++pos) {
+        board.setTile(pos, cells[pos]);
+        if (cells[pos] == 0) {
+            board.blank = pos;
+        }
+    }
+    if (permutationParity(board) != permutationParity(goal)) {
+        int first = board.blank == 0 ? 1 : 0;
+        int second = board.blank == N * N - 1 ? N * N - 2 : N * N - 1;
+        int tile = board.tileAt(first);
+        board.setTile(first, board.tileAt(second));
+        board.setTile(second, tile);
+    }
+    return board;
+}
+
+// Board reached from goal by k random blank moves, never undoing the move
+// just made. The optimal solution is at most k moves, so k sets the
+// difficulty.
+template <int N>
+PackedBoard<N> randomWalkBoard(std::mt19937_64& rng, const PackedBoard<N>& goal, int k) {
+    const MoveTable<N>& table = moveTable<N>();
+    PackedBoard<N> board = goal;
+    int previous = -1;
+    for (int step = 0; step < k; ++step) {
+        int options[4];
+        int count = 0;
+        for (int m = 0; m < table.count[board.blank]; ++m) {
+            if (table.target[board.blank][m] != previous) {
+                options[count++] = table.target[board.blank][m];
+            }
+        }
+        previous = board.blank;
+        board.applySlide(options[randomBelow(rng, count)]);
+    }
+    return board;
+}
+
+template <int N>
+void writeBoard(std::string& out, const PackedBoard<N>& board) {
+    for (int pos = 0; pos < N * N; ++pos) {
+        if (pos > 0) {
+            out += ' ';
+        }
+        out += std::to_string(board.tileAt(pos));
+    }
+}
+
+// Appends one instance in the solvers' batch format: the initial state, then
+// the goal state, on one line.
+template <int N>
+void writeInstance(std::string& out, const PackedBoard<N>& initial, const PackedBoard<N>& goal) {
+    writeBoard(out, initial);
+    out += "  ";
+    writeBoard(out, goal);
+    out += '\n';
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef GOAL_TABLE_H
+#define GOAL_TABLE_H
+
+#include <bits/stdc++.h>
+#include "packed_board.h"
+
+// Built once per goal so heuristics never search the goal board again.
+// distance[tile][pos] is the Manhattan distance of tile from pos to its goal
+// cell, with the blank's row left at zero.
+template <int N>
+struct GoalTable {
+    int goalRow[N * N];
+    int goalCol[N * N];
+    int distance[N * N][N * N];
+};
+
+template <int N>
+GoalTable<N> buildGoalTable(const PackedBoard<N>& goal) {
+    GoalTable<N> table;
+    for (int pos = 0; pos < N * N; ++pos) {
+        int tile = goal.tileAt(pos);
+        table.goalRow[tile] = pos / N;
+        table.goalCol[tile] = pos % N;
+    }
+    for (int tile = 0; tile < N * N; ++tile) {
+        for (int pos = 0; pos < N * N; ++pos) {
+            table.distance[tile][pos] =
+                tile == 0 ? 0 : std::abs(pos / N - table.goalRow[tile]) + std::abs(pos % N - table.goalCol[tile]);
+        }
+    }
+    return table;
+}
+
+// Heuristic changes for sliding tile from cell `from` into the blank at `to`;
+// no other tile moves, so only its own contribution changes.
+template <int N>
+int manhattanDelta(const GoalTable<N>& table, int tile, int from, int to) {
+    return table.distance[tile][to] - table.distance[tile][from];
+}
+
+template <int N>
+int misplacedDelta(const GoalTable<N>& table, int tile, int from, int to) {
+    int goalPos = table.goalRow[tile] * N + table.goalCol[tile];
+    return (goalPos == from) - (goalPos == to);
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef HEURISTIC_KERNELS_H
+#define HEURISTIC_KERNELS_H
+
+#include <bits/stdc++.h>
+#include "goal_table.h"
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(PUZZLE_SCALAR_KERNELS)
+#define PUZZLE_VECTOR_KERNELS
+#include <immintrin.h>
+#endif
+
+// Full Manhattan distance and misplaced-tile counts for many boards at once,
+// given as a column of packed tile words (boards up to 4x4, one uint64_t
+// each). The vector kernels spread a board's sixteen nibbles over the bytes
+// of a register, look up each tile's goal row and column with a byte
+// shuffle, and add the absolute differences with a sum of absolute
+// differences against zero: one board per SSSE3 register, two per AVX2
+// register. The CPU is checked once at run time; other compilers and
+// -DPUZZLE_SCALAR_KERNELS builds use the scalar loop. Misplaced tiles need no
+// vector code: XOR with the goal word and a popcount of the nonzero nibbles
+// is already branch-free.
+
+enum HeuristicKernel {
+    SCALAR_KERNEL,
+    SSSE3_KERNEL,
+    AVX2_KERNEL
+};
+
+inline const char* kernelName(HeuristicKernel kernel) {
+    switch (kernel) {
+    case AVX2_KERNEL:
+        return "avx2";
+    case SSSE3_KERNEL:
+        return "ssse3";
+    default:
+        return "scalar";
+    }
+}
+
+inline HeuristicKernel detectHeuristicKernel() {
+#ifdef PUZZLE_VECTOR_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2_KERNEL;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return SSSE3_KERNEL;
+    }
+#endif
+    return SCALAR_KERNEL;
+}
+
+inline HeuristicKernel heuristicKernel() {
+    static const HeuristicKernel kernel = detectHeuristicKernel();
+    return kernel;
+}
+
+// Byte tables for the shuffles: the goal row and column of every tile, and
+// the row and column of every cell. The blank's entries are never used. The
+// scalar loop reads distance[tile][pos] instead, zero for the blank.
+struct KernelTables {
+    alignas(16) uint8_t goalRow[16];
+    alignas(16) uint8_t goalCol[16];
+    alignas(16) uint8_t cellRow[16];
+    alignas(16) uint8_t cellCol[16];
+    uint8_t distance[16][16];
+    uint64_t goalTiles;
+    uint64_t cellMask;
+    int goalBlank;
+};
+
+template <int N>
+KernelTables buildKernelTables(const GoalTable<N>& goal) {
+    static_assert(N <= 4, "the kernels take one 64-bit word per board");
+    KernelTables tables = {};
+    for (int tile = 0; tile < N * N; ++tile) {
+        tables.goalRow[tile] = (uint8_t)goal.goalRow[tile];
+        tables.goalCol[tile] = (uint8_t)goal.goalCol[tile];
+        int pos = goal.goalRow[tile] * N + goal.goalCol[tile];
+        tables.goalTiles |= (uint64_t)tile << (4 * pos);
+    }
+    for (int pos = 0; pos < N * N; ++pos) {
+        tables.cellRow[pos] = (uint8_t)(pos / N);
+        tables.cellCol[pos] = (uint8_t)(pos % N);
+        tables.cellMask |= 1ULL << (4 * pos);
+        for (int tile = 0; tile < N * N; ++tile) {
+            tables.distance[tile][pos] = (uint8_t)goal.distance[tile][pos];
+        }
+    }
+    tables.goalBlank = goal.goalRow[0] * N + goal.goalCol[0];
+    return tables;
+}
+
+inline int manhattanScalar(const KernelTables& tables, uint64_t tiles) {
+    int distance = 0;
+    for (int pos = 0; tiles != 0; ++pos, tiles >>= 4) {
+        distance += tables.distance[tiles & 15][pos];
+    }
+    return distance;
+}
+
+inline int misplacedTiles(const KernelTables& tables, uint64_t tiles) {
+    uint64_t differ = tiles ^ tables.goalTiles;
+    differ = (differ | differ >> 1 | differ >> 2 | differ >> 3) & tables.cellMask;
+    // The blank's own cell differs whenever the blank is away from home.
+    return __builtin_popcountll(differ) - (((tiles >> (4 * tables.goalBlank)) & 15) != 0);
+}
+
+#ifdef PUZZLE_VECTOR_KERNELS
+__attribute__((target("ssse3"))) inline __m128i unpackTiles(uint64_t tiles) {
+    __m128i word = _mm_cvtsi64_si128((long long)tiles);
+    __m128i nibble = _mm_set1_epi8(15);
+    return _mm_unpacklo_epi8(_mm_and_si128(word, nibble), _mm_and_si128(_mm_srli_epi16(word, 4), nibble));
+}
+
+__attribute__((target("ssse3"))) inline void manhattanSsse3(const KernelTables& tables, const uint64_t* tiles,
+                                                             size_t count, int* values) {
+    __m128i goalRow = _mm_load_si128((const __m128i*)tables.goalRow);
+    __m128i goalCol = _mm_load_si128((const __m128i*)tables.goalCol);
+    __m128i cellRow = _mm_load_si128((const __m128i*)tables.cellRow);
+    __m128i cellCol = _mm_load_si128((const __m128i*)tables.cellCol);
+    __m128i zero = _mm_setzero_si128();
+    for (size_t i = 0; i < count; ++i) {
+        __m128i cells = unpackTiles(tiles[i]);
+        __m128i rows = _mm_abs_epi8(_mm_sub_epi8(_mm_shuffle_epi8(goalRow, cells), cellRow));
+        __m128i cols = _mm_abs_epi8(_mm_sub_epi8(_mm_shuffle_epi8(goalCol, cells), cellCol));
+        __m128i sum = _mm_andnot_si128(_mm_cmpeq_epi8(cells, zero), _mm_add_epi8(rows, cols));
+        sum = _mm_sad_epu8(sum, zero);
+        values[i] = _mm_cvtsi128_si32(_mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum)));
+    }
+}
+
+__attribute__((target("avx2"))) inline void manhattanAvx2(const KernelTables& tables, const uint64_t* tiles,
+                                                          size_t count, int* values) {
+    __m256i goalRow = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)tables.goalRow));
+    __m256i goalCol = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)tables.goalCol));
+    __m256i cellRow = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)tables.cellRow));
+    __m256i cellCol = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)tables.cellCol));
+    __m256i nibble = _mm256_set1_epi8(15);
+    __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        // Each 128-bit lane holds one board; shuffles stay within lanes.
+        __m256i words = _mm256_setr_epi64x((long long)tiles[i], 0, (long long)tiles[i + 1], 0);
+        __m256i cells = _mm256_unpacklo_epi8(_mm256_and_si256(words, nibble),
+                                             _mm256_and_si256(_mm256_srli_epi16(words, 4), nibble));
+        __m256i rows = _mm256_abs_epi8(_mm256_sub_epi8(_mm256_shuffle_epi8(goalRow, cells), cellRow));
+        __m256i cols = _mm256_abs_epi8(_mm256_sub_epi8(_mm256_shuffle_epi8(goalCol, cells), cellCol));
+        __m256i sum = _mm256_andnot_si256(_mm256_cmpeq_epi8(cells, zero), _mm256_add_epi8(rows, cols));
+        sum = _mm256_sad_epu8(sum, zero);
+        sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi64(sum, sum));
+        values[i] = _mm256_cvtsi256_si32(sum);
+        values[i + 1] = _mm_cvtsi128_si32(_mm256_extracti128_si256(sum, 1));
+    }
+    if (i < count) {
+        manhattanSsse3(tables, tiles + i, count - i, values + i);
+    }
+}
+#endif
+
+inline void manhattanBatch(const KernelTables& tables, const uint64_t* tiles, size_t count, int* values) {
+#ifdef PUZZLE_VECTOR_KERNELS
+    switch (heuristicKernel()) {
+    case AVX2_KERNEL:
+        manhattanAvx2(tables, tiles, count, values);
+        return;
+    case SSSE3_KERNEL:
+        manhattanSsse3(tables, tiles, count, values);
+        return;
+    default:
+        break;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = manhattanScalar(tables, tiles[i]);
+    }
+}
+
+inline void misplacedBatch(const KernelTables& tables, const uint64_t* tiles, size_t count, int* values) {
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = misplacedTiles(tables, tiles[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <bits/stdc++.h>
+#include "goal_table.h"
+#include "heuristic_kernels.h"
+#include "linear_conflict.h"
+#include "packed_board.h"
+#include "pattern_database.h"
+#include "walking_distance.h"
+
+enum HeuristicKind {
+    MANHATTAN_DISTANCE,
+    MISPLACED_TILES,
+    PATTERN_DATABASE,
+    LINEAR_CONFLICT,
+    WALKING_DISTANCE
+};
+
+const char HEURISTIC_NAMES[] = "manhattan, misplaced, linear-conflict, walking-distance or pdb";
+
+inline bool parseHeuristicKind(const std::string& name, HeuristicKind& kind) {
+    if (name == "manhattan") {
+        kind = MANHATTAN_DISTANCE;
+    } else if (name == "misplaced") {
+        kind = MISPLACED_TILES;
+    } else if (name == "pdb") {
+        kind = PATTERN_DATABASE;
+    } else if (name == "linear-conflict") {
+        kind = LINEAR_CONFLICT;
+    } else if (name == "walking-distance") {
+        kind = WALKING_DISTANCE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// The 5x5 walking-distance table has too many states to build in memory.
+template <int N>
+bool heuristicSupported(HeuristicKind kind) {
+    return kind != WALKING_DISTANCE || N <= 4;
+}
+
+template <int N>
+int calculateManhattanDistance(const PackedBoard<N>& state, const GoalTable<N>& goal) {
+    int distance = 0;
+    for (int pos = 0; pos < N * N; ++pos) {
+        distance += goal.distance[state.tileAt(pos)][pos];
+    }
+    return distance;
+}
+
+template <int N>
+int calculateMisplacedTiles(const PackedBoard<N>& state, const GoalTable<N>& goal) {
+    int misplacedTiles = 0;
+    for (int pos = 0; pos < N * N; ++pos) {
+        int tile = state.tileAt(pos);
+        if (tile != 0 && goal.goalRow[tile] * N + goal.goalCol[tile] != pos) {
+            misplacedTiles++;
+        }
+    }
+    return misplacedTiles;
+}
+
+// A heuristic bound to one goal. Searches score the start board with
+// evaluate() and every move after that with update(). PATTERN_DATABASE
+// needs a database built for the same goal, which must outlive the heuristic.
+template <int N>
+class Heuristic {
+public:
+    typedef typename PackedBoard<N>::Word Word;
+
+    Heuristic(HeuristicKind heuristicKind, const PackedBoard<N>& goal, const PatternDatabase<N>* tables = nullptr)
+        : kind(heuristicKind), table(buildGoalTable(goal)), kernels(), database(tables), rowDistances(nullptr),
+          columnDistances(nullptr) {
+        assert(kind != PATTERN_DATABASE || (database != nullptr && database->builtForGoal() == goal));
+        assert(heuristicSupported<N>(kind));
+        if (kind == WALKING_DISTANCE) {
+            rowDistances = &walkingDistanceTable<N>(table.goalRow[0]);
+            columnDistances = &walkingDistanceTable<N>(table.goalCol[0]);
+        }
+        if constexpr (N <= 4) {
+            kernels = buildKernelTables(table);
+        }
+    }
+
+    int evaluate(const PackedBoard<N>& board) const {
+        switch (kind) {
+        case MISPLACED_TILES:
+            return calculateMisplacedTiles(board, table);
+        case PATTERN_DATABASE:
+            return database->evaluate(board);
+        case LINEAR_CONFLICT:
+            return calculateLinearConflict(board, table);
+        case WALKING_DISTANCE:
+            return calculateWalkingDistance(board, table, *rowDistances, *columnDistances);
+        default:
+            return calculateManhattanDistance(board, table);
+        }
+    }
+
+    // Scores count boards given by their packed tile words. Manhattan
+    // distance and misplaced tiles on boards up to 4x4 use the batch kernels;
+    // the other heuristics score one board at a time.
+    void evaluateMany(const Word* tiles, size_t count, int* values) const {
+        if constexpr (N <= 4) {
+            if (kind == MANHATTAN_DISTANCE) {
+                manhattanBatch(kernels, tiles, count, values);
+                return;
+            }
+            if (kind == MISPLACED_TILES) {
+                misplacedBatch(kernels, tiles, count, values);
+                return;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            PackedBoard<N> board = {tiles[i], 0};
+            while (board.tileAt(board.blank) != 0) {
+                board.blank++;
+            }
+            values[i] = evaluate(board);
+        }
+    }
+
+    // h for `board`, reached from a board scored h by sliding tile from cell
+    // `from` into the blank at `to`.
+    int update(const PackedBoard<N>& board, int h, int tile, int from, int to) const {
+        int next;
+        switch (kind) {
+        case MISPLACED_TILES:
+            next = h + misplacedDelta(table, tile, from, to);
+            break;
+        case PATTERN_DATABASE:
+            next = database->update(board, h, tile, from, to);
+            break;
+        case LINEAR_CONFLICT:
+            next = linearConflictUpdate(board, table, h, tile, from, to);
+            break;
+        case WALKING_DISTANCE:
+            next = walkingDistanceUpdate(board, table, *rowDistances, *columnDistances, h, tile, from, to);
+            break;
+        default:
+            next = h + manhattanDelta(table, tile, from, to);
+            break;
+        }
+        assert(next == evaluate(board));
+        (void)board;
+        return next;
+    }
+
+private:
+    HeuristicKind kind;
+    GoalTable<N> table;
+    KernelTables kernels;
+    const PatternDatabase<N>* database;
+    const WalkingDistanceTable<N>* rowDistances;
+    const WalkingDistanceTable<N>* columnDistances;
+};
+
+#endif
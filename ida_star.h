@@ -0,0 +1,122 @@
+#ifndef IDA_STAR_H
+#define IDA_STAR_H
+
+#include <bits/stdc++.h>
+#include "heuristics.h"
+#include "packed_board.h"
+#include "search_budget.h"
+
+// Without a solution, moveCount and path lead to the state with the lowest
+// heuristic seen, remainingEstimate moves from the goal by that heuristic.
+struct IdaStarResult {
+    bool solved;
+    int moveCount;
+    std::string path;
+    long long expandedNodes;
+    BudgetLimit budgetLimit;
+    int remainingEstimate;
+};
+
+// Iterative-deepening A*: repeated depth-first searches bounded by f = g + h,
+// each raising the bound to the smallest f that exceeded the previous one.
+// The board is modified in place and undone on return, and the move that
+// would return to the parent is never tried, so memory stays proportional
+// to the solution depth. Nothing is stored per node, so only the node and
+// time budgets apply.
+template <int N>
+class IdaStar {
+public:
+    explicit IdaStar(const Heuristic<N>& estimate) : heuristic(estimate), expandedNodes(0) {}
+
+    // The caller must check solvability first; otherwise this only returns
+    // when the budget runs out.
+    IdaStarResult solve(const PackedBoard<N>& start, const PackedBoard<N>& goal,
+                        const SearchBudget& budget = SearchBudget()) {
+        board = start;
+        target = goal;
+        blankPath.assign(1, start.blank);
+        expandedNodes = 0;
+        monitor.reset(new BudgetMonitor(budget));
+
+        int h = heuristic.evaluate(board);
+        closestPath = blankPath;
+        closestHeuristic = h;
+        int bound = h;
+        int next;
+        do {
+            next = search(0, h, bound);
+            bound = next;
+        } while (next != FOUND && next != ABORTED);
+
+        IdaStarResult result;
+        result.solved = next == FOUND;
+        result.budgetLimit = budgetLimit;
+        result.remainingEstimate = result.solved ? 0 : closestHeuristic;
+        const std::vector<int>& path = result.solved ? blankPath : closestPath;
+        result.moveCount = (int)path.size() - 1;
+        result.path.clear();
+        for (size_t i = 1; i < path.size(); ++i) {
+            result.path += moveName<N>(path[i - 1], path[i]);
+        }
+        result.expandedNodes = expandedNodes;
+        return result;
+    }
+
+private:
+    static const int FOUND = -1;
+    static const int ABORTED = -2;
+
+    // Returns FOUND with blankPath holding the solution, ABORTED when the
+    // budget ran out, or the smallest f seen above bound in this subtree.
+    int search(int g, int h, int bound) {
+        int f = g + h;
+        if (f > bound) {
+            return f;
+        }
+        if (board == target) {
+            return FOUND;
+        }
+        expandedNodes++;
+        if (h < closestHeuristic) {
+            closestHeuristic = h;
+            closestPath = blankPath;
+        }
+        if (monitor->exhausted(expandedNodes, [] { return (size_t)0; }, budgetLimit)) {
+            return ABORTED;
+        }
+
+        const MoveTable<N>& table = moveTable<N>();
+        int blank = board.blank;
+        int parent = blankPath.size() > 1 ? blankPath[blankPath.size() - 2] : -1;
+        int minimum = INT_MAX;
+        for (int k = 0; k < table.count[blank]; ++k) {
+            int from = table.target[blank][k];
+            if (from == parent) {
+                continue;
+            }
+            int tile = board.tileAt(from);
+            board.applySlide(from);
+            blankPath.push_back(from);
+            int t = search(g + 1, heuristic.update(board, h, tile, from, blank), bound);
+            if (t == FOUND || t == ABORTED) {
+                return t;
+            }
+            blankPath.pop_back();
+            board.applySlide(blank);
+            minimum = std::min(minimum, t);
+        }
+        return minimum;
+    }
+
+    const Heuristic<N>& heuristic;
+    PackedBoard<N> board;
+    PackedBoard<N> target;
+    std::vector<int> blankPath;
+    long long expandedNodes;
+    std::unique_ptr<BudgetMonitor> monitor;
+    BudgetLimit budgetLimit = NODE_BUDGET;
+    std::vector<int> closestPath;
+    int closestHeuristic = 0;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include <bits/stdc++.h>
+#include "generator.h"
+#include "packed_board.h"
+using namespace std;
+
+const int FLUSH_BYTES = 1 << 20;
+
+template <int N>
+int writeCorpus(const string& goalText, int count, int minMoves, int maxMoves, uint64_t seed, const string& output) {
+    vector<vector<int>> goalCells(N, vector<int>(N));
+    if (goalText.empty()) {
+        for (int pos = 0; pos < N * N; ++pos) {
+            goalCells[pos / N][pos % N] = (pos + 1) % (N * N);
+        }
+    } else {
+        istringstream in(goalText);
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                if (!(in >> goalCells[i][j])) {
+                    cout << "The goal needs " << N * N << " numbers." << endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    PackedBoard<N> goal = packBoard<N>(goalCells);
+
+    FILE* file = output == "-" ? stdout : fopen(output.c_str(), "wb");
+    if (file == nullptr) {
+        cout << "Cannot write " << output << endl;
+        return 1;
+    }
+
+    mt19937_64 rng(seed);
+    string buffer;
+    buffer.reserve(FLUSH_BYTES + 256);
+    bool failed = false;
+    for (int i = 0; i < count && !failed; ++i) {
+        PackedBoard<N> initial;
+        if (maxMoves < 0) {
+            initial = randomSolvableBoard<N>(rng, goal);
+        } else {
+            int moves = minMoves + (int)randomBelow(rng, maxMoves - minMoves + 1);
+            initial = randomWalkBoard<N>(rng, goal, moves);
+        }
+        writeInstance(buffer, initial, goal);
+        if (buffer.size() >= (size_t)FLUSH_BYTES || i == count - 1) {
+            failed = fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size();
+            buffer.clear();
+        }
+    }
+    if (fflush(file) != 0) {
+        failed = true;
+    }
+    if (file != stdout) {
+        failed = fclose(file) != 0 || failed;
+    }
+    if (failed) {
+        cout << "Cannot write " << output << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int size = 3;
+    int count = 0;
+    int minMoves = -1;
+    int maxMoves = -1;
+    uint64_t seed = DEFAULT_SEED;
+    string goalText, output;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (arg == "--count" && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (arg == "--moves" && i + 1 < argc) {
+            string range = argv[++i];
+            size_t dash = range.find('-');
+            minMoves = atoi(range.substr(0, dash).c_str());
+            maxMoves = dash == string::npos ? minMoves : atoi(range.substr(dash + 1).c_str());
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--goal" && i + 1 < argc) {
+            goalText = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        }
+    }
+
+    if (output.empty() || count <= 0) {
+        cout << "Usage: instance-generator --count C --output FILE|- [--size 3|4|5] [--seed S]" << endl
+             << "                          [--moves K | --moves A-B] [--goal \"1 2 ... 0\"]" << endl
+             << "Without --moves, initial states are uniform over the states that can reach the goal;" << endl
+             << "with it, each is a random walk of K (or A to B) moves from the goal." << endl;
+        return 1;
+    }
+    if (maxMoves >= 0 && (minMoves < 0 || minMoves > maxMoves)) {
+        cout << "--moves needs K or A-B with 0 <= A <= B." << endl;
+        return 1;
+    }
+
+    switch (size) {
+    case 3:
+        return writeCorpus<3>(goalText, count, minMoves, maxMoves, seed, output);
+    case 4:
+        return writeCorpus<4>(goalText, count, minMoves, maxMoves, seed, output);
+    case 5:
+        return writeCorpus<5>(goalText, count, minMoves, maxMoves, seed, output);
+    default:
+        cout << "Unsupported board size " << size << " (expected 3, 4 or 5)." << endl;
+        return 1;
+    }
+}
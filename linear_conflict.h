@@ -0,0 +1,97 @@
+#ifndef LINEAR_CONFLICT_H
+#define LINEAR_CONFLICT_H
+
+#include <bits/stdc++.h>
+#include "goal_table.h"
+#include "packed_board.h"
+
+// Extra moves forced by tiles that sit in their goal line but in the wrong
+// order: all but a longest increasing run of them must leave the line and
+// come back, two moves each. A line is keyed by one base-(N+1) digit per
+// cell, the tile's goal index within the line plus one, or 0 when the cell
+// holds the blank or a tile whose goal is in another line.
+template <int N>
+struct LinearConflictTable {
+    static constexpr int KEYS = N == 2 ? 9 : N == 3 ? 64 : N == 4 ? 625 : 7776;
+    uint8_t conflicts[KEYS];
+
+    LinearConflictTable() {
+        for (int key = 0; key < KEYS; ++key) {
+            int digits[N];
+            int count = 0;
+            for (int i = 0, rest = key; i < N; ++i, rest /= N + 1) {
+                if (rest % (N + 1) != 0) {
+                    digits[count++] = rest % (N + 1);
+                }
+            }
+            int longest[N];
+            int best = 0;
+            for (int i = 0; i < count; ++i) {
+                longest[i] = 1;
+                for (int j = 0; j < i; ++j) {
+                    if (digits[j] < digits[i]) {
+                        longest[i] = std::max(longest[i], longest[j] + 1);
+                    }
+                }
+                best = std::max(best, longest[i]);
+            }
+            conflicts[key] = 2 * (count - best);
+        }
+    }
+};
+
+template <int N>
+const LinearConflictTable<N>& linearConflictTable() {
+    static const LinearConflictTable<N> table;
+    return table;
+}
+
+template <int N>
+int rowConflicts(const PackedBoard<N>& board, const GoalTable<N>& goal, int row) {
+    int key = 0;
+    for (int col = N - 1; col >= 0; --col) {
+        int tile = board.tileAt(row * N + col);
+        key = key * (N + 1) + (tile != 0 && goal.goalRow[tile] == row ? goal.goalCol[tile] + 1 : 0);
+    }
+    return linearConflictTable<N>().conflicts[key];
+}
+
+template <int N>
+int columnConflicts(const PackedBoard<N>& board, const GoalTable<N>& goal, int col) {
+    int key = 0;
+    for (int row = N - 1; row >= 0; --row) {
+        int tile = board.tileAt(row * N + col);
+        key = key * (N + 1) + (tile != 0 && goal.goalCol[tile] == col ? goal.goalRow[tile] + 1 : 0);
+    }
+    return linearConflictTable<N>().conflicts[key];
+}
+
+template <int N>
+int calculateLinearConflict(const PackedBoard<N>& state, const GoalTable<N>& goal) {
+    int total = 0;
+    for (int pos = 0; pos < N * N; ++pos) {
+        total += goal.distance[state.tileAt(pos)][pos];
+    }
+    for (int line = 0; line < N; ++line) {
+        total += rowConflicts(state, goal, line) + columnConflicts(state, goal, line);
+    }
+    return total;
+}
+
+// A horizontal slide keeps the tile order of its row, so only the two
+// columns it touches are rescored, and vice versa for vertical slides.
+template <int N>
+int linearConflictUpdate(const PackedBoard<N>& board, const GoalTable<N>& goal, int h, int tile, int from, int to) {
+    PackedBoard<N> before = board.slide(to);
+    int next = h + manhattanDelta(goal, tile, from, to);
+    if (from / N == to / N) {
+        next += columnConflicts(board, goal, from % N) + columnConflicts(board, goal, to % N);
+        next -= columnConflicts(before, goal, from % N) + columnConflicts(before, goal, to % N);
+    } else {
+        next += rowConflicts(board, goal, from / N) + rowConflicts(board, goal, to / N);
+        next -= rowConflicts(before, goal, from / N) + rowConflicts(before, goal, to / N);
+    }
+    return next;
+}
+
+#endif
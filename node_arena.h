@@ -0,0 +1,75 @@
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+#include <bits/stdc++.h>
+
+const uint32_t NO_PARENT = UINT32_MAX;
+
+// Search nodes addressed by a 32-bit index and stored in fixed-capacity
+// chunks. A chunk is never reallocated, so references to nodes stay valid
+// while the search keeps allocating, and the whole arena is released (or
+// recycled with clear) in one go when the search ends.
+template <class Node>
+class NodeArena {
+public:
+    static const int CHUNK_BITS = 14;
+    static const uint32_t CHUNK_NODES = 1u << CHUNK_BITS;
+
+    NodeArena() : count(0) {}
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    uint32_t allocate(const Node& node) {
+        uint32_t chunk = count >> CHUNK_BITS;
+        if (chunk == chunks.size()) {
+            chunks.emplace_back();
+            chunks.back().reserve(CHUNK_NODES);
+        }
+        chunks[chunk].push_back(node);
+        return count++;
+    }
+
+    Node& operator[](uint32_t index) {
+        return chunks[index >> CHUNK_BITS][index & (CHUNK_NODES - 1)];
+    }
+
+    const Node& operator[](uint32_t index) const {
+        return chunks[index >> CHUNK_BITS][index & (CHUNK_NODES - 1)];
+    }
+
+    uint32_t size() const {
+        return count;
+    }
+
+    size_t memoryBytes() const {
+        return chunks.size() * CHUNK_NODES * sizeof(Node);
+    }
+
+    // Drops every node but keeps the chunks for the next search.
+    void clear() {
+        for (std::vector<Node>& chunk : chunks) {
+            chunk.clear();
+        }
+        count = 0;
+    }
+
+private:
+    std::vector<std::vector<Node>> chunks;
+    uint32_t count;
+};
+
+// Follows parent links from a node back to the root and returns the blank's
+// moves from the root to that node, one 'U', 'D', 'L' or 'R' per move.
+// Nodes must have a parent index (NO_PARENT at the root) and a move.
+template <class Node>
+std::string reconstructPath(const NodeArena<Node>& arena, uint32_t index) {
+    std::string path;
+    for (; arena[index].parent != NO_PARENT; index = arena[index].parent) {
+        path += arena[index].move;
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef OPEN_LIST_H
+#define OPEN_LIST_H
+
+#include <bits/stdc++.h>
+
+// Both open lists hold node indices and pop the lowest primary key, then the
+// highest secondary key, then the most recently pushed node. The A* solvers
+// pass (f, g) and the greedy solvers pass (h, 0), so the two implementations
+// expand exactly the same nodes and can be benchmarked against each other.
+enum OpenListKind {
+    BUCKET_OPEN_LIST,
+    HEAP_OPEN_LIST
+};
+
+inline bool parseOpenListKind(const std::string& name, OpenListKind& kind) {
+    if (name == "bucket") {
+        kind = BUCKET_OPEN_LIST;
+    } else if (name == "heap") {
+        kind = HEAP_OPEN_LIST;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Keys in this domain are small non-negative integers, so a bucket per
+// primary key, split into LIFO stacks per secondary key, gives O(1) pushes
+// and pops that only move forward through the buckets.
+class BucketOpenList {
+public:
+    BucketOpenList() : lowest(INT_MAX), count(0) {}
+
+    void push(uint32_t node, int primary, int secondary) {
+        if (primary >= (int)buckets.size()) {
+            buckets.resize(primary + 1);
+        }
+        Bucket& bucket = buckets[primary];
+        if (secondary >= (int)bucket.stacks.size()) {
+            bucket.stacks.resize(secondary + 1);
+        }
+        bucket.stacks[secondary].push_back(node);
+        bucket.highest = std::max(bucket.highest, secondary);
+        bucket.count++;
+        lowest = std::min(lowest, primary);
+        count++;
+    }
+
+    uint32_t pop() {
+        while (buckets[lowest].count == 0) {
+            lowest++;
+        }
+        Bucket& bucket = buckets[lowest];
+        while (bucket.stacks[bucket.highest].empty()) {
+            bucket.highest--;
+        }
+        std::vector<uint32_t>& stack = bucket.stacks[bucket.highest];
+        uint32_t node = stack.back();
+        stack.pop_back();
+        bucket.count--;
+        count--;
+        return node;
+    }
+
+    // Primary key of the next pop.
+    int topKey() {
+        while (buckets[lowest].count == 0) {
+            lowest++;
+        }
+        return lowest;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // Counts the queued entries, not the stacks' spare capacity.
+    size_t memoryBytes() const {
+        return count * sizeof(uint32_t) + buckets.size() * sizeof(Bucket);
+    }
+
+    // Empties the list but keeps every stack's capacity for the next search.
+    void clear() {
+        for (Bucket& bucket : buckets) {
+            for (std::vector<uint32_t>& stack : bucket.stacks) {
+                stack.clear();
+            }
+            bucket.highest = -1;
+            bucket.count = 0;
+        }
+        lowest = INT_MAX;
+        count = 0;
+    }
+
+private:
+    struct Bucket {
+        std::vector<std::vector<uint32_t>> stacks;
+        int highest = -1;
+        size_t count = 0;
+    };
+
+    std::vector<Bucket> buckets;
+    int lowest;
+    size_t count;
+};
+
+class HeapOpenList {
+public:
+    HeapOpenList() : pushes(0) {}
+
+    void push(uint32_t node, int primary, int secondary) {
+        heap.push_back(Entry{primary, secondary, pushes++, node});
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    uint32_t pop() {
+        std::pop_heap(heap.begin(), heap.end());
+        uint32_t node = heap.back().node;
+        heap.pop_back();
+        return node;
+    }
+
+    int topKey() {
+        return heap.front().primary;
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    size_t memoryBytes() const {
+        return heap.capacity() * sizeof(Entry);
+    }
+
+    void clear() {
+        heap.clear();
+        pushes = 0;
+    }
+
+private:
+    struct Entry {
+        int primary;
+        int secondary;
+        uint64_t order;
+        uint32_t node;
+
+        // std heaps are max-heaps: "less" means popped later.
+        bool operator<(const Entry& other) const {
+            if (primary != other.primary) {
+                return primary > other.primary;
+            }
+            if (secondary != other.secondary) {
+                return secondary < other.secondary;
+            }
+            return order < other.order;
+        }
+    };
+
+    std::vector<Entry> heap;
+    uint64_t pushes;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <bits/stdc++.h>
+#include "batch.h"
+
+enum Verbosity {
+    SILENT,
+    SUMMARY,
+    TRACE
+};
+
+inline bool parseVerbosity(const std::string& name, Verbosity& verbosity) {
+    if (name == "silent") {
+        verbosity = SILENT;
+    } else if (name == "summary") {
+        verbosity = SUMMARY;
+    } else if (name == "trace") {
+        verbosity = TRACE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+enum OutputFormat {
+    TEXT_OUTPUT,
+    JSON_OUTPUT,
+    CSV_OUTPUT
+};
+
+inline bool parseOutputFormat(const std::string& name, OutputFormat& format) {
+    if (name == "text") {
+        format = TEXT_OUTPUT;
+    } else if (name == "json") {
+        format = JSON_OUTPUT;
+    } else if (name == "csv") {
+        format = CSV_OUTPUT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* statusName(SolveStatus status) {
+    switch (status) {
+    case SOLVED:
+        return "solved";
+    case NOT_SOLVABLE:
+        return "not-solvable";
+    case BUDGET_EXCEEDED:
+        return "budget-exceeded";
+    default:
+        return "no-solution";
+    }
+}
+
+// Collects everything printed for one instance and hands it to stdout in a
+// single write, rather than flushing on every line with endl.
+class OutputBuffer {
+public:
+    std::ostream& stream() {
+        return text;
+    }
+
+    void flush() {
+        std::string pending = text.str();
+        if (!pending.empty()) {
+            fwrite(pending.data(), 1, pending.size(), stdout);
+            fflush(stdout);
+        }
+        text.str("");
+    }
+
+private:
+    std::ostringstream text;
+};
+
+inline void writeCsvHeader(std::ostream& out) {
+    out << "instance,status,moves,path,expanded,time_ms,budget,remaining,bound\n";
+}
+
+// One line per instance. The JSON and CSV forms have the same fields; paths
+// only ever contain U, D, L and R, so nothing needs escaping. A result that
+// ran out of budget carries its best partial path in moves and path, plus
+// the budget that ran out and the heuristic estimate of what remains.
+// Solutions from a weighted search carry their suboptimality bound.
+inline void writeResult(OutputFormat format, std::ostream& out, size_t instance, const SolveResult& result) {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    bool solved = result.status == SOLVED;
+    bool partial = result.status == BUDGET_EXCEEDED;
+    if (format == JSON_OUTPUT) {
+        out << "{\"instance\":" << instance << ",\"status\":\"" << statusName(result.status) << "\",\"moves\":";
+        if (solved || partial) {
+            out << result.moveCount << ",\"path\":\"" << result.path << "\"";
+        } else {
+            out << "null,\"path\":null";
+        }
+        out << ",\"expanded\":" << result.expandedNodes << ",\"time_ms\":" << result.seconds * 1000;
+        if (partial) {
+            out << ",\"budget\":\"" << budgetName(result.budgetLimit) << "\",\"remaining\":"
+                << result.remainingEstimate;
+        }
+        if (solved && result.bound > 1) {
+            out << ",\"bound\":" << result.bound;
+        }
+        out << "}\n";
+    } else if (format == CSV_OUTPUT) {
+        out << instance << "," << statusName(result.status) << ",";
+        if (solved || partial) {
+            out << result.moveCount << "," << result.path;
+        } else {
+            out << ",";
+        }
+        out << "," << result.expandedNodes << "," << result.seconds * 1000 << ",";
+        if (partial) {
+            out << budgetName(result.budgetLimit) << "," << result.remainingEstimate;
+        } else {
+            out << ",";
+        }
+        out << ",";
+        if (solved) {
+            out << result.bound;
+        }
+        out << "\n";
+    } else {
+        out << "Instance " << instance << ": ";
+        if (solved) {
+            out << "solved in " << result.moveCount << " moves (" << result.path << ")";
+            if (result.bound > 1) {
+                out << ", at most " << result.bound << " times optimal";
+            }
+        } else if (result.status == NOT_SOLVABLE) {
+            out << "not solvable";
+        } else if (partial) {
+            out << "stopped by the " << budgetName(result.budgetLimit) << " budget, best partial path "
+                << result.moveCount << " moves (" << result.path << ") with about " << result.remainingEstimate
+                << " to go";
+        } else {
+            out << "no solution found";
+        }
+        if (result.status != NOT_SOLVABLE) {
+            out << ", " << result.expandedNodes << " nodes expanded";
+        }
+        out << ", " << result.seconds * 1000 << " ms\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+// A request the server could not run. The CSV form carries the message in
+// the path column; quotes, backslashes, commas and control characters in it
+// are replaced so that no format needs escaping.
+inline void writeError(OutputFormat format, std::ostream& out, size_t instance, std::string message) {
+    for (char& c : message) {
+        if (c == '"' || c == '\\' || c == ',' || (unsigned char)c < ' ') {
+            c = '?';
+        }
+    }
+    if (format == JSON_OUTPUT) {
+        out << "{\"instance\":" << instance << ",\"status\":\"error\",\"error\":\"" << message << "\"}\n";
+    } else if (format == CSV_OUTPUT) {
+        out << instance << ",error,," << message << ",,,,,\n";
+    } else {
+        out << "Instance " << instance << ": " << message << "\n";
+    }
+}
+
+// Prints batch results in input order, one write per instance, followed by
+// a summary line in text form.
+inline void writeBatchResults(const std::vector<SolveResult>& results, OutputFormat format, Verbosity verbosity,
+                              int threads, double seconds) {
+    if (verbosity == SILENT) {
+        return;
+    }
+    OutputBuffer out;
+    if (format == CSV_OUTPUT) {
+        writeCsvHeader(out.stream());
+    }
+    int solved = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        solved += results[i].status == SOLVED;
+        writeResult(format, out.stream(), i + 1, results[i]);
+        out.flush();
+    }
+    if (format == TEXT_OUTPUT) {
+        out.stream() << std::fixed << std::setprecision(3) << "Solved " << solved << " of " << results.size()
+                     << " instances in " << seconds << " s on " << threads << " threads.\n";
+        out.flush();
+    }
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef PACKED_BOARD_H
+#define PACKED_BOARD_H
+
+#include <bits/stdc++.h>
+
+// Storage for an N x N board: 4 bits per tile fits up to the 15-puzzle in
+// one uint64_t, the 24-puzzle needs 5 bits per tile and a 128-bit word.
+template <int N>
+struct BoardTraits {
+    static_assert(N >= 2 && N <= 5, "supported board sizes are 2x2 to 5x5");
+    static constexpr int DIM = N;
+    static constexpr int CELLS = N * N;
+    static constexpr int BITS = N <= 4 ? 4 : 5;
+    typedef typename std::conditional<N <= 4, uint64_t, unsigned __int128>::type Word;
+};
+
+// One tile per BITS-wide field, position 0 in the lowest bits, with the blank
+// index cached so successor generation never has to scan for it.
+template <int N>
+struct PackedBoard {
+    typedef typename BoardTraits<N>::Word Word;
+    static constexpr int DIM = N;
+    static constexpr int CELLS = N * N;
+    static constexpr int BITS = BoardTraits<N>::BITS;
+    static constexpr Word FIELD = (Word(1) << BITS) - 1;
+
+    Word tiles;
+    int blank;
+
+    int tileAt(int pos) const {
+        return (int)((tiles >> (BITS * pos)) & FIELD);
+    }
+
+    void setTile(int pos, int value) {
+        tiles = (tiles & ~(FIELD << (BITS * pos))) | ((Word)value << (BITS * pos));
+    }
+
+    // Slides the tile at pos into the blank; pos must be adjacent to the blank.
+    void applySlide(int pos) {
+        setTile(blank, tileAt(pos));
+        setTile(pos, 0);
+        blank = pos;
+    }
+
+    PackedBoard slide(int pos) const {
+        PackedBoard next = *this;
+        next.applySlide(pos);
+        return next;
+    }
+
+    bool operator==(const PackedBoard& other) const {
+        return tiles == other.tiles;
+    }
+
+    bool operator!=(const PackedBoard& other) const {
+        return tiles != other.tiles;
+    }
+};
+
+// Neighbouring positions of every cell, in the order up, down, left, right.
+template <int N>
+struct MoveTable {
+    int count[N * N];
+    int target[N * N][4];
+
+    constexpr MoveTable() : count(), target() {
+        const int moves[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (int pos = 0; pos < N * N; ++pos) {
+            for (int m = 0; m < 4; ++m) {
+                int row = pos / N + moves[m][0];
+                int col = pos % N + moves[m][1];
+                if (row >= 0 && row < N && col >= 0 && col < N) {
+                    target[pos][count[pos]++] = row * N + col;
+                }
+            }
+        }
+    }
+};
+
+template <int N>
+inline constexpr MoveTable<N> MOVE_TABLE{};
+
+template <int N>
+inline const MoveTable<N>& moveTable() {
+    return MOVE_TABLE<N>;
+}
+
+// Direction the blank travels when it moves from one cell to a neighbour.
+template <int N>
+char moveName(int fromBlank, int toBlank) {
+    if (toBlank == fromBlank - N) {
+        return 'U';
+    }
+    if (toBlank == fromBlank + N) {
+        return 'D';
+    }
+    return toBlank < fromBlank ? 'L' : 'R';
+}
+
+template <int N>
+PackedBoard<N> packBoard(const std::vector<std::vector<int>>& cells) {
+    PackedBoard<N> board = {0, 0};
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            board.setTile(i * N + j, cells[i][j]);
+            if (cells[i][j] == 0) {
+                board.blank = i * N + j;
+            }
+        }
+    }
+    return board;
+}
+
+template <int N>
+std::vector<std::vector<int>> unpackBoard(const PackedBoard<N>& board) {
+    std::vector<std::vector<int>> cells(N, std::vector<int>(N, 0));
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            cells[i][j] = board.tileAt(i * N + j);
+        }
+    }
+    return cells;
+}
+
+// Inversions among the numbered tiles, plus the blank's row on even widths
+// where every vertical move flips the inversion parity. Two boards are
+// reachable from each other exactly when this parity matches.
+template <int N>
+int permutationParity(const PackedBoard<N>& board) {
+    int inversions = 0;
+    for (int i = 0; i < N * N - 1; ++i) {
+        int a = board.tileAt(i);
+        for (int j = i + 1; j < N * N; ++j) {
+            int b = board.tileAt(j);
+            if (a && b && a > b) {
+                inversions++;
+            }
+        }
+    }
+    if constexpr (N % 2 == 0) {
+        inversions += board.blank / N;
+    }
+    return inversions & 1;
+}
+
+#endif
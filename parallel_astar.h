@@ -0,0 +1,384 @@
+#ifndef PARALLEL_ASTAR_H
+#define PARALLEL_ASTAR_H
+
+#include <bits/stdc++.h>
+#include "closed_set.h"
+#include "heuristics.h"
+#include "node_arena.h"
+#include "open_list.h"
+#include "packed_board.h"
+#include "search_budget.h"
+
+// When the budget runs out, moveCount and path are the best solution found
+// so far, which need not be optimal, with remainingEstimate 0; without one,
+// they lead to the expanded state with the lowest heuristic, remainingEstimate
+// moves from the goal by that heuristic.
+struct ParallelAStarResult {
+    bool solved;
+    bool budgetExceeded;
+    int moveCount;
+    std::string path;
+    long long expandedNodes;
+    BudgetLimit budgetLimit;
+    int remainingEstimate;
+};
+
+// Hash-distributed A* (HDA*). Every state is owned by the worker that its
+// hash selects; only the owner keeps it in its open list and its table of
+// best known g values, so workers never share a data structure. A generated
+// state owned by another worker is buffered and sent to that worker's inbox.
+//
+// Workers expand in their own f order, not the global one, so the first goal
+// found is only an upper bound. Search continues, pruning everything whose f
+// reaches the best cost, until no worker has work left and no message is in
+// flight; the incumbent is then optimal for an admissible heuristic.
+//
+// Each worker checks the budget itself against the expansions of all
+// workers, which it only learns every FLUSH_INTERVAL expansions, so the node
+// budget may be overrun by that much per worker. The first worker to find the
+// budget spent stops all of them.
+template <int N>
+class ParallelAStar {
+public:
+    ParallelAStar(const Heuristic<N>& estimate, int threads)
+        : heuristic(estimate), threadCount(std::max(1, std::min(threads, 1 << 15))) {}
+
+    // The caller must check solvability first; otherwise this only returns
+    // when the budget runs out.
+    ParallelAStarResult solve(const PackedBoard<N>& start, const PackedBoard<N>& goal,
+                              const SearchBudget& budget = SearchBudget()) {
+        target = goal;
+        workers.clear();
+        for (int w = 0; w < threadCount; ++w) {
+            workers.emplace_back(new Worker(threadCount, budget));
+        }
+        bestCost.store(INT_MAX);
+        bestWorker = -1;
+        bestIndex = NO_PARENT;
+        active.store(threadCount);
+        stopped.store(false);
+        stopLimit = NODE_BUDGET;
+        expandedTotal.store(0);
+
+        Node root = {start, 0, heuristic.evaluate(start), NO_PARENT, 0, -1, 0};
+        insert(*workers[ownerOf(start)], root);
+
+        std::vector<std::thread> threads;
+        for (int w = 1; w < threadCount; ++w) {
+            threads.emplace_back(&ParallelAStar::run, this, w);
+        }
+        run(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        ParallelAStarResult result;
+        result.budgetExceeded = stopped.load();
+        result.solved = bestWorker >= 0 && !result.budgetExceeded;
+        result.moveCount = 0;
+        result.budgetLimit = stopLimit;
+        result.remainingEstimate = 0;
+        result.expandedNodes = 0;
+        int closestWorker = -1;
+        for (int w = 0; w < threadCount; ++w) {
+            const Worker& worker = *workers[w];
+            result.expandedNodes += worker.expandedNodes;
+            if (worker.closest != NO_PARENT &&
+                (closestWorker < 0 ||
+                 worker.nodes[worker.closest].h < workers[closestWorker]->nodes[workers[closestWorker]->closest].h)) {
+                closestWorker = w;
+            }
+        }
+        if (bestWorker >= 0) {
+            result.moveCount = bestCost.load();
+            result.path = pathTo(bestWorker, bestIndex);
+        } else if (result.budgetExceeded && closestWorker >= 0) {
+            const Node& closest = workers[closestWorker]->nodes[workers[closestWorker]->closest];
+            result.moveCount = closest.g;
+            result.path = pathTo(closestWorker, workers[closestWorker]->closest);
+            result.remainingEstimate = closest.h;
+        }
+        workers.clear();
+        return result;
+    }
+
+private:
+    // Nodes outside the owner's open list are only ever moved in batches, to
+    // keep the number of atomic operations and allocations per node low.
+    static const size_t BATCH_SIZE = 64;
+    static const int FLUSH_INTERVAL = 256;
+
+    struct Node {
+        PackedBoard<N> board;
+        int g;
+        int h;
+        uint32_t parent;
+        uint16_t parentWorker;
+        int8_t parentBlank;
+        char move;
+    };
+
+    struct Batch {
+        Batch* next;
+        std::vector<Node> nodes;
+    };
+
+    // Multi-producer single-consumer queue: producers push onto a lock-free
+    // stack and the owner takes the whole stack at once, so there is no ABA.
+    class Inbox {
+    public:
+        Inbox() : head(nullptr) {}
+
+        void push(Batch* batch) {
+            batch->next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(batch->next, batch, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+            }
+        }
+
+        Batch* takeAll() {
+            if (head.load(std::memory_order_relaxed) == nullptr) {
+                return nullptr;
+            }
+            return head.exchange(nullptr, std::memory_order_acquire);
+        }
+
+    private:
+        std::atomic<Batch*> head;
+    };
+
+    struct Worker {
+        Worker(int threads, const SearchBudget& budget)
+            : outgoing(threads, nullptr), expandedNodes(0), unreported(0), closest(NO_PARENT), monitor(budget),
+              memoryBytes(0) {}
+
+        ~Worker() {
+            for (Batch* batch : outgoing) {
+                delete batch;
+            }
+            for (Batch* batch = inbox.takeAll(); batch != nullptr;) {
+                Batch* next = batch->next;
+                delete batch;
+                batch = next;
+            }
+        }
+
+        BucketOpenList openList;
+        NodeArena<Node> nodes;
+        BestNodeMap<N> bestNode;
+        Inbox inbox;
+        std::vector<Batch*> outgoing;
+        long long expandedNodes;
+        // Expansions not yet added to expandedTotal.
+        long long unreported;
+        uint32_t closest;
+        BudgetMonitor monitor;
+        // This worker's last estimate of its own memory, for the others to
+        // read when they check the memory budget.
+        std::atomic<size_t> memoryBytes;
+    };
+
+    std::string pathTo(int w, uint32_t index) const {
+        std::string path;
+        const Node* node = &workers[w]->nodes[index];
+        for (; node->parent != NO_PARENT; node = &workers[node->parentWorker]->nodes[node->parent]) {
+            path += node->move;
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    int ownerOf(const PackedBoard<N>& board) const {
+        return (int)(mixHash(board.tiles) % (uint64_t)threadCount);
+    }
+
+    // Termination: active counts busy workers plus batches in flight. A batch
+    // is counted before it is pushed and uncounted after its nodes are in the
+    // receiver's open list, and an idle worker counts itself busy again before
+    // uncounting the batches that woke it, so active only reaches zero once
+    // no work is left anywhere, and then stays there. Once the budget is
+    // spent, every worker returns as soon as it sees stopped.
+    void run(int w) {
+        Worker& self = *workers[w];
+        bool busy = true;
+        int sinceFlush = 0;
+        while (!stopped.load(std::memory_order_relaxed)) {
+            Batch* batch = self.inbox.takeAll();
+            if (batch != nullptr) {
+                if (!busy) {
+                    active.fetch_add(1);
+                    busy = true;
+                }
+                receive(self, batch);
+            }
+            if (!busy) {
+                if (active.load() == 0) {
+                    return;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            if (expandNext(w)) {
+                if (++sinceFlush == FLUSH_INTERVAL) {
+                    flush(self);
+                    sinceFlush = 0;
+                }
+                continue;
+            }
+            flush(self);
+            expandedTotal.fetch_add(self.unreported);
+            self.unreported = 0;
+            busy = false;
+            active.fetch_sub(1);
+        }
+    }
+
+    void receive(Worker& self, Batch* batch) {
+        while (batch != nullptr) {
+            for (const Node& node : batch->nodes) {
+                insert(self, node);
+            }
+            Batch* next = batch->next;
+            delete batch;
+            active.fetch_sub(1);
+            batch = next;
+        }
+    }
+
+    void insert(Worker& self, const Node& node) {
+        if (node.g + node.h >= bestCost.load(std::memory_order_relaxed)) {
+            return;
+        }
+        uint32_t known;
+        if (self.bestNode.find(node.board, known) && self.nodes[known].g <= node.g) {
+            return;
+        }
+        uint32_t index = self.nodes.allocate(node);
+        self.bestNode.assign(node.board, index);
+        self.openList.push(index, node.g + node.h, node.g);
+    }
+
+    void send(Worker& self, int owner, const Node& node) {
+        Batch*& batch = self.outgoing[owner];
+        if (batch == nullptr) {
+            batch = new Batch();
+            batch->nodes.reserve(BATCH_SIZE);
+        }
+        batch->nodes.push_back(node);
+        if (batch->nodes.size() == BATCH_SIZE) {
+            active.fetch_add(1);
+            workers[owner]->inbox.push(batch);
+            batch = nullptr;
+        }
+    }
+
+    void flush(Worker& self) {
+        expandedTotal.fetch_add(self.unreported, std::memory_order_relaxed);
+        self.unreported = 0;
+        for (size_t owner = 0; owner < self.outgoing.size(); ++owner) {
+            if (self.outgoing[owner] != nullptr) {
+                active.fetch_add(1);
+                workers[owner]->inbox.push(self.outgoing[owner]);
+                self.outgoing[owner] = nullptr;
+            }
+        }
+    }
+
+    // Expands the best open node that can still improve on the incumbent.
+    // Returns false when there is none.
+    bool expandNext(int w) {
+        Worker& self = *workers[w];
+        while (!self.openList.empty()) {
+            if (self.openList.topKey() >= bestCost.load(std::memory_order_relaxed)) {
+                self.openList.clear();
+                return false;
+            }
+            uint32_t index = self.openList.pop();
+            const Node& current = self.nodes[index];
+            uint32_t known;
+            if (!self.bestNode.find(current.board, known) || known != index) {
+                continue;
+            }
+            if (current.board == target) {
+                std::lock_guard<std::mutex> guard(bestLock);
+                if (current.g < bestCost.load()) {
+                    bestCost.store(current.g);
+                    bestWorker = w;
+                    bestIndex = index;
+                }
+                return true;
+            }
+            self.expandedNodes++;
+            self.unreported++;
+            if (self.closest == NO_PARENT || current.h < self.nodes[self.closest].h) {
+                self.closest = index;
+            }
+
+            const MoveTable<N>& table = moveTable<N>();
+            int blank = current.board.blank;
+            for (int k = 0; k < table.count[blank]; ++k) {
+                int from = table.target[blank][k];
+                if (from == current.parentBlank) {
+                    continue;
+                }
+                int tile = current.board.tileAt(from);
+                Node child;
+                child.board = current.board.slide(from);
+                child.g = current.g + 1;
+                child.h = heuristic.update(child.board, current.h, tile, from, blank);
+                child.parent = index;
+                child.parentWorker = (uint16_t)w;
+                child.parentBlank = (int8_t)blank;
+                child.move = moveName<N>(blank, from);
+                int owner = ownerOf(child.board);
+                if (owner == w) {
+                    insert(self, child);
+                } else {
+                    send(self, owner, child);
+                }
+            }
+            checkBudget(self);
+            return true;
+        }
+        return false;
+    }
+
+    void checkBudget(Worker& self) {
+        BudgetLimit limit;
+        long long expanded = expandedTotal.load(std::memory_order_relaxed) + self.unreported;
+        if (!self.monitor.exhausted(expanded, [&] { return memoryBytes(self); }, limit)) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(bestLock);
+        if (!stopped.load()) {
+            stopLimit = limit;
+            stopped.store(true);
+        }
+    }
+
+    // Publishes self's estimate and returns the total over all workers.
+    size_t memoryBytes(Worker& self) {
+        self.memoryBytes.store(self.nodes.memoryBytes() + self.openList.memoryBytes() + self.bestNode.memoryBytes(),
+                               std::memory_order_relaxed);
+        size_t total = 0;
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            total += worker->memoryBytes.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    const Heuristic<N>& heuristic;
+    int threadCount;
+    PackedBoard<N> target;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int> bestCost;
+    std::mutex bestLock;
+    int bestWorker;
+    uint32_t bestIndex;
+    std::atomic<long long> active;
+    std::atomic<bool> stopped;
+    BudgetLimit stopLimit;
+    std::atomic<long long> expandedTotal;
+};
+
+#endif
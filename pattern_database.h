@@ -0,0 +1,327 @@
+#ifndef PATTERN_DATABASE_H
+#define PATTERN_DATABASE_H
+
+#include <bits/stdc++.h>
+#include "packed_board.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// On-disk layout, all integers little endian:
+//   PatternDatabaseHeader
+//   PatternGroupHeader[groupCount]
+//   entry tables, each starting at its group's 64-byte aligned offset
+// A group's table holds one byte per placement of its tiles: the fewest moves
+// of those tiles needed to bring them home, blank moves being free. Groups are
+// disjoint, so the sum over all groups is admissible.
+const char PATTERN_DATABASE_MAGIC[8] = {'P', 'U', 'Z', 'P', 'D', 'B', '1', '\0'};
+const int MAX_PATTERN_TILES = 8;
+
+struct PatternDatabaseHeader {
+    char magic[8];
+    uint32_t dim;
+    uint32_t groupCount;
+    uint32_t bitsPerEntry;
+    uint32_t reserved;
+    uint8_t goal[32];
+    uint8_t padding[8];
+};
+
+struct PatternGroupHeader {
+    uint8_t tiles[MAX_PATTERN_TILES];
+    uint32_t tileCount;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t entryCount;
+};
+
+static_assert(sizeof(PatternDatabaseHeader) == 64, "header layout is part of the file format");
+static_assert(sizeof(PatternGroupHeader) == 32, "group layout is part of the file format");
+
+// Number of ways to place k distinct items on n cells.
+inline uint64_t placementCount(int n, int k) {
+    uint64_t count = 1;
+    for (int i = 0; i < k; ++i) {
+        count *= n - i;
+    }
+    return count;
+}
+
+// Perfect hash of k distinct cell indices in [0, n) onto
+// [0, placementCount(n, k)): each position is renumbered among the cells not
+// taken by earlier ones.
+inline uint64_t placementRank(const int* positions, int k, int n) {
+    uint64_t rank = 0;
+    uint32_t used = 0;
+    for (int i = 0; i < k; ++i) {
+        int pos = positions[i];
+        rank = rank * (n - i) + (pos - __builtin_popcount(used & ((1u << pos) - 1)));
+        used |= 1u << pos;
+    }
+    return rank;
+}
+
+inline void placementUnrank(uint64_t rank, int* positions, int k, int n) {
+    int digits[MAX_PATTERN_TILES + 1];
+    for (int i = k - 1; i >= 0; --i) {
+        digits[i] = (int)(rank % (n - i));
+        rank /= n - i;
+    }
+    uint32_t used = 0;
+    for (int i = 0; i < k; ++i) {
+        int pos = 0;
+        for (int skip = digits[i];; ++pos) {
+            if (!(used & (1u << pos))) {
+                if (skip == 0) {
+                    break;
+                }
+                skip--;
+            }
+        }
+        positions[i] = pos;
+        used |= 1u << pos;
+    }
+}
+
+// Read-only view of a whole file. Pages are shared between every process that
+// maps the same database.
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), length(0) {
+#ifdef _WIN32
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#endif
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                           nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            close();
+            return false;
+        }
+        data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            close();
+            return false;
+        }
+        length = (size_t)size.QuadPart;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        data = (const uint8_t*)address;
+        length = (size_t)info.st_size;
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (data != nullptr) {
+            munmap((void*)data, length);
+        }
+#endif
+        data = nullptr;
+        length = 0;
+    }
+
+    const uint8_t* bytes() const {
+        return data;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    const uint8_t* data;
+    size_t length;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+template <int N>
+class PatternDatabase {
+public:
+    PatternDatabase() : groupCount(0) {}
+
+    // Maps a database file and checks that it was built for N x N boards.
+    // On failure, returns false and describes the problem in error.
+    bool open(const std::string& path, std::string& error) {
+        groupCount = 0;
+        if (!file.open(path)) {
+            error = "cannot map " + path;
+            return false;
+        }
+        const uint8_t* base = file.bytes();
+        if (file.size() < sizeof(PatternDatabaseHeader)) {
+            error = path + " is too small to be a pattern database";
+            return false;
+        }
+        PatternDatabaseHeader header;
+        memcpy(&header, base, sizeof(header));
+        if (memcmp(header.magic, PATTERN_DATABASE_MAGIC, sizeof(header.magic)) != 0 || header.bitsPerEntry != 8) {
+            error = path + " is not a pattern database";
+            return false;
+        }
+        if (header.dim != (uint32_t)N) {
+            error = path + " was built for " + std::to_string(header.dim) + "x" + std::to_string(header.dim) +
+                    " boards";
+            return false;
+        }
+        if (header.groupCount == 0 || header.groupCount > (uint32_t)(N * N) ||
+            file.size() < sizeof(header) + header.groupCount * sizeof(PatternGroupHeader)) {
+            error = path + " has a corrupt group table";
+            return false;
+        }
+        goal = PackedBoard<N>{0, 0};
+        for (int pos = 0; pos < N * N; ++pos) {
+            goal.setTile(pos, header.goal[pos]);
+            if (header.goal[pos] == 0) {
+                goal.blank = pos;
+            }
+        }
+
+        std::fill(groupOf, groupOf + N * N, -1);
+        for (uint32_t g = 0; g < header.groupCount; ++g) {
+            PatternGroupHeader group;
+            memcpy(&group, base + sizeof(header) + g * sizeof(group), sizeof(group));
+            if (group.tileCount == 0 || group.tileCount > (uint32_t)MAX_PATTERN_TILES ||
+                group.entryCount != placementCount(N * N, group.tileCount) ||
+                group.offset + group.entryCount > file.size()) {
+                error = path + " has a corrupt group table";
+                return false;
+            }
+            groups[g].tileCount = group.tileCount;
+            groups[g].entries = base + group.offset;
+            for (uint32_t i = 0; i < group.tileCount; ++i) {
+                int tile = group.tiles[i];
+                if (tile <= 0 || tile >= N * N || groupOf[tile] != -1) {
+                    error = path + " has overlapping or invalid pattern tiles";
+                    return false;
+                }
+                groups[g].tiles[i] = tile;
+                groupOf[tile] = g;
+                indexInGroup[tile] = i;
+            }
+        }
+        groupCount = header.groupCount;
+        return true;
+    }
+
+    const PackedBoard<N>& builtForGoal() const {
+        return goal;
+    }
+
+    int evaluate(const PackedBoard<N>& board) const {
+        int positionOf[N * N];
+        for (int pos = 0; pos < N * N; ++pos) {
+            positionOf[board.tileAt(pos)] = pos;
+        }
+        int total = 0;
+        for (int g = 0; g < groupCount; ++g) {
+            total += lookup(g, positionOf);
+        }
+        return total;
+    }
+
+    // Only the group of the moved tile changes, so only it is looked up again.
+    int update(const PackedBoard<N>& board, int h, int tile, int from, int to) const {
+        int g = groupOf[tile];
+        if (g < 0) {
+            return h;
+        }
+        int positions[MAX_PATTERN_TILES];
+        const Group& group = groups[g];
+        for (int pos = 0; pos < N * N; ++pos) {
+            int other = board.tileAt(pos);
+            if (other != 0 && groupOf[other] == g) {
+                positions[indexInGroup[other]] = pos;
+            }
+        }
+        int after = group.entries[placementRank(positions, group.tileCount, N * N)];
+        positions[indexInGroup[tile]] = from;
+        int before = group.entries[placementRank(positions, group.tileCount, N * N)];
+        (void)to;
+        return h - before + after;
+    }
+
+private:
+    struct Group {
+        int tileCount;
+        int tiles[MAX_PATTERN_TILES];
+        const uint8_t* entries;
+    };
+
+    int lookup(int g, const int* positionOf) const {
+        const Group& group = groups[g];
+        int positions[MAX_PATTERN_TILES];
+        for (int i = 0; i < group.tileCount; ++i) {
+            positions[i] = positionOf[group.tiles[i]];
+        }
+        return group.entries[placementRank(positions, group.tileCount, N * N)];
+    }
+
+    MappedFile file;
+    PackedBoard<N> goal;
+    Group groups[N * N];
+    int groupCount;
+    int groupOf[N * N];
+    int indexInGroup[N * N];
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include <bits/stdc++.h>
+#include "packed_board.h"
+#include "pattern_database.h"
+using namespace std;
+
+const uint8_t UNSEEN = 0xFF;
+
+template <int N>
+vector<vector<int>> defaultGroups() {
+    if (N == 3) {
+        return {{1, 2, 3, 4}, {5, 6, 7, 8}};
+    }
+    if (N == 4) {
+        return {{1, 5, 6, 9, 10, 13}, {7, 8, 11, 12, 14, 15}, {2, 3, 4}};
+    }
+    return {{1, 2, 3, 6, 7}, {4, 5, 8, 9, 10}, {11, 12, 16, 17, 21}, {13, 14, 15, 18, 19}, {20, 22, 23, 24}};
+}
+
+// Retrograde breadth-first search from the goal over placements of the
+// group's tiles plus the blank. Moving the blank onto a cell outside the
+// group is free, moving it onto a group tile costs one, so each level is
+// closed under free moves before the next one starts.
+template <int N>
+vector<uint8_t> buildGroupTable(const PackedBoard<N>& goal, const vector<int>& tiles) {
+    const int cells = N * N;
+    const int k = tiles.size();
+    const MoveTable<N>& table = moveTable<N>();
+    uint64_t stateCount = placementCount(cells, k + 1);
+    vector<uint8_t> distance(stateCount, UNSEEN);
+
+    int positions[MAX_PATTERN_TILES + 1];
+    for (int i = 0; i < k; ++i) {
+        for (int pos = 0; pos < cells; ++pos) {
+            if (goal.tileAt(pos) == tiles[i]) {
+                positions[i] = pos;
+            }
+        }
+    }
+    positions[k] = goal.blank;
+
+    vector<uint32_t> current, next;
+    uint32_t start = placementRank(positions, k + 1, cells);
+    distance[start] = 0;
+    current.push_back(start);
+
+    for (int depth = 0; !current.empty(); ++depth) {
+        next.clear();
+        for (size_t i = 0; i < current.size(); ++i) {
+            uint32_t index = current[i];
+            if (distance[index] != depth) {
+                continue;
+            }
+            placementUnrank(index, positions, k + 1, cells);
+            int owner[cells];
+            fill(owner, owner + cells, -1);
+            for (int j = 0; j < k; ++j) {
+                owner[positions[j]] = j;
+            }
+
+            int blank = positions[k];
+            for (int m = 0; m < table.count[blank]; ++m) {
+                int target = table.target[blank][m];
+                int j = owner[target];
+                positions[k] = target;
+                if (j >= 0) {
+                    positions[j] = blank;
+                }
+                uint32_t neighbour = placementRank(positions, k + 1, cells);
+                if (j < 0 && (distance[neighbour] == UNSEEN || distance[neighbour] > depth)) {
+                    distance[neighbour] = depth;
+                    current.push_back(neighbour);
+                } else if (j >= 0 && distance[neighbour] == UNSEEN) {
+                    distance[neighbour] = depth + 1;
+                    next.push_back(neighbour);
+                }
+                if (j >= 0) {
+                    positions[j] = target;
+                }
+            }
+            positions[k] = blank;
+        }
+        swap(current, next);
+    }
+
+    // The blank is the last, radix (cells - k), digit of a state's rank, so
+    // the states sharing one tile placement are consecutive.
+    uint64_t entryCount = placementCount(cells, k);
+    vector<uint8_t> entries(entryCount, UNSEEN);
+    for (uint64_t e = 0; e < entryCount; ++e) {
+        for (int b = 0; b < cells - k; ++b) {
+            entries[e] = min(entries[e], distance[e * (cells - k) + b]);
+        }
+    }
+    return entries;
+}
+
+template <int N>
+int buildDatabase(const PackedBoard<N>& goal, const vector<vector<int>>& groups, const string& output) {
+    vector<bool> used(N * N, false);
+    for (const vector<int>& group : groups) {
+        if (group.empty() || group.size() > (size_t)MAX_PATTERN_TILES ||
+            placementCount(N * N, group.size() + 1) > UINT32_MAX) {
+            cout << "Each group needs between 1 and " << MAX_PATTERN_TILES
+                 << " tiles and must fit a 32-bit state index." << endl;
+            return 1;
+        }
+        for (int tile : group) {
+            if (tile <= 0 || tile >= N * N || used[tile]) {
+                cout << "Tile " << tile << " is out of range or appears in more than one group." << endl;
+                return 1;
+            }
+            used[tile] = true;
+        }
+    }
+
+    PatternDatabaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PATTERN_DATABASE_MAGIC, sizeof(header.magic));
+    header.dim = N;
+    header.groupCount = groups.size();
+    header.bitsPerEntry = 8;
+    for (int pos = 0; pos < N * N; ++pos) {
+        header.goal[pos] = goal.tileAt(pos);
+    }
+
+    vector<PatternGroupHeader> groupHeaders(groups.size());
+    vector<vector<uint8_t>> tables;
+    uint64_t offset = sizeof(header) + groups.size() * sizeof(PatternGroupHeader);
+    for (size_t g = 0; g < groups.size(); ++g) {
+        tables.push_back(buildGroupTable(goal, groups[g]));
+        offset = (offset + 63) & ~uint64_t(63);
+        PatternGroupHeader& group = groupHeaders[g];
+        memset(&group, 0, sizeof(group));
+        group.tileCount = groups[g].size();
+        for (size_t i = 0; i < groups[g].size(); ++i) {
+            group.tiles[i] = groups[g][i];
+        }
+        group.offset = offset;
+        group.entryCount = tables.back().size();
+        offset += group.entryCount;
+
+        cout << "Group " << g + 1 << " (tiles";
+        for (int tile : groups[g]) {
+            cout << " " << tile;
+        }
+        cout << "): " << group.entryCount << " entries, at most "
+             << (int)*max_element(tables.back().begin(), tables.back().end()) << " moves" << endl;
+    }
+
+    ofstream out(output, ios::binary);
+    if (!out) {
+        cout << "Cannot write " << output << endl;
+        return 1;
+    }
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)groupHeaders.data(), groupHeaders.size() * sizeof(PatternGroupHeader));
+    for (size_t g = 0; g < tables.size(); ++g) {
+        uint64_t position = out.tellp();
+        vector<char> padding(groupHeaders[g].offset - position, 0);
+        out.write(padding.data(), padding.size());
+        out.write((const char*)tables[g].data(), tables[g].size());
+    }
+    if (!out) {
+        cout << "Cannot write " << output << endl;
+        return 1;
+    }
+    cout << "Wrote " << output << endl;
+    return 0;
+}
+
+vector<vector<int>> parseGroups(const string& text) {
+    vector<vector<int>> groups(1);
+    string number;
+    for (char c : text + "/") {
+        if (isdigit((unsigned char)c)) {
+            number += c;
+            continue;
+        }
+        if (!number.empty()) {
+            groups.back().push_back(stoi(number));
+            number.clear();
+        }
+        if (c == '/') {
+            groups.push_back({});
+        }
+    }
+    groups.pop_back();
+    return groups;
+}
+
+template <int N>
+int runBuilder(const string& goalText, const string& groupText, const string& output) {
+    vector<vector<int>> goalCells(N, vector<int>(N));
+    if (goalText.empty()) {
+        for (int pos = 0; pos < N * N; ++pos) {
+            goalCells[pos / N][pos % N] = (pos + 1) % (N * N);
+        }
+    } else {
+        istringstream in(goalText);
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                if (!(in >> goalCells[i][j])) {
+                    cout << "The goal needs " << N * N << " numbers." << endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    vector<vector<int>> groups = groupText.empty() ? defaultGroups<N>() : parseGroups(groupText);
+    return buildDatabase<N>(packBoard<N>(goalCells), groups, output);
+}
+
+int main(int argc, char* argv[]) {
+    int size = 4;
+    string goalText, groupText, output;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (arg == "--goal" && i + 1 < argc) {
+            goalText = argv[++i];
+        } else if (arg == "--groups" && i + 1 < argc) {
+            groupText = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        }
+    }
+
+    if (output.empty()) {
+        cout << "Usage: pdb-builder --output FILE [--size 3|4|5] [--goal \"1 2 ... 0\"]" << endl
+             << "                   [--groups \"1,2,3/4,5,6\"]" << endl;
+        return 1;
+    }
+
+    switch (size) {
+    case 3:
+        return runBuilder<3>(goalText, groupText, output);
+    case 4:
+        return runBuilder<4>(goalText, groupText, output);
+    case 5:
+        return runBuilder<5>(goalText, groupText, output);
+    default:
+        cout << "Unsupported board size " << size << " (expected 3, 4 or 5)." << endl;
+        return 1;
+    }
+}
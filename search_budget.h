@@ -0,0 +1,76 @@
+#ifndef SEARCH_BUDGET_H
+#define SEARCH_BUDGET_H
+
+#include <bits/stdc++.h>
+
+enum BudgetLimit {
+    NODE_BUDGET,
+    TIME_BUDGET,
+    MEMORY_BUDGET
+};
+
+inline const char* budgetName(BudgetLimit limit) {
+    switch (limit) {
+    case NODE_BUDGET:
+        return "node";
+    case TIME_BUDGET:
+        return "time";
+    default:
+        return "memory";
+    }
+}
+
+const size_t DEFAULT_MEMORY_BUDGET_MB = 2048;
+
+// Limits on one solve; 0 means no limit. Nodes count expansions, and memory
+// is the search's own estimate of what its node store, closed set and open
+// list hold, not the process size.
+struct SearchBudget {
+    long long maxNodes = 0;
+    double seconds = 0;
+    size_t memoryBytes = DEFAULT_MEMORY_BUDGET_MB << 20;
+};
+
+// Tracks one solve against its budget. Reading the clock costs more than an
+// expansion, so the deadline and memory are only checked every
+// CHECK_INTERVAL expansions and may be overrun by that much.
+class BudgetMonitor {
+public:
+    static const long long CHECK_INTERVAL = 1024;
+
+    explicit BudgetMonitor(const SearchBudget& limits)
+        : budget(limits), deadline(std::chrono::steady_clock::now() +
+                                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                       std::chrono::duration<double>(limits.seconds))),
+          nextCheck(CHECK_INTERVAL) {}
+
+    // Returns true once the budget is spent, with the limit that ran out.
+    // memoryBytes is only called when memory is checked.
+    template <class MemoryBytes>
+    bool exhausted(long long expanded, MemoryBytes memoryBytes, BudgetLimit& limit) {
+        if (budget.maxNodes > 0 && expanded >= budget.maxNodes) {
+            limit = NODE_BUDGET;
+            return true;
+        }
+        if (expanded < nextCheck) {
+            return false;
+        }
+        nextCheck = expanded + CHECK_INTERVAL;
+        if (budget.seconds > 0 && std::chrono::steady_clock::now() >= deadline) {
+            limit = TIME_BUDGET;
+            return true;
+        }
+        if (budget.memoryBytes > 0 && memoryBytes() >= budget.memoryBytes) {
+            limit = MEMORY_BUDGET;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    SearchBudget budget;
+    std::chrono::steady_clock::time_point deadline;
+    long long nextCheck;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <bits/stdc++.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Instrumentation of the search loops. It is compiled in only when
+// PUZZLE_STATS is defined (g++ -DPUZZLE_STATS ...); otherwise the macros
+// below expand to nothing and release builds pay nothing for it.
+
+enum SearchPhase {
+    HEURISTIC_PHASE,
+    SUCCESSOR_PHASE,
+    CLOSED_SET_PHASE,
+    QUEUE_PHASE,
+    PHASE_COUNT
+};
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {"heuristic", "successors", "closed set", "open list"};
+
+// Time stamp counter where there is one, nanoseconds elsewhere.
+inline uint64_t readCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Counters kept alongside SolveResult::expandedNodes. A duplicate is a
+// state that was dropped because it had already been closed or reached as
+// cheaply; a reopening is a state reached again by a shorter path, which
+// only searches that keep the best g per state notice. The successor time
+// includes the heuristic time spent inside it, and every phase includes the
+// timers' own overhead, so compare phases with each other rather than with
+// the total.
+struct SearchStats {
+    long long generated = 0;
+    long long duplicates = 0;
+    long long reopened = 0;
+    size_t peakOpen = 0;
+    size_t peakClosed = 0;
+    uint64_t cycles[PHASE_COUNT] = {};
+    long long calls[PHASE_COUNT] = {};
+};
+
+class ScopedPhaseTimer {
+public:
+    ScopedPhaseTimer(SearchStats& into, SearchPhase timed) : stats(into), phase(timed), start(readCycleCounter()) {}
+
+    ~ScopedPhaseTimer() {
+        stats.cycles[phase] += readCycleCounter() - start;
+        stats.calls[phase]++;
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+    SearchStats& stats;
+    SearchPhase phase;
+    uint64_t start;
+};
+
+inline void writeSearchStats(std::ostream& out, const SearchStats& stats) {
+    out << "Generated: " << stats.generated << ", duplicates: " << stats.duplicates << ", reopened: " << stats.reopened
+        << '\n';
+    out << "Peak open: " << stats.peakOpen << ", peak closed: " << stats.peakClosed << '\n';
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        out << "Time in " << PHASE_NAMES[phase] << ": " << stats.cycles[phase] << " cycles over " << stats.calls[phase]
+            << " calls\n";
+    }
+}
+
+#define SEARCH_STATS_CONCAT2(a, b) a##b
+#define SEARCH_STATS_CONCAT(a, b) SEARCH_STATS_CONCAT2(a, b)
+
+#ifdef PUZZLE_STATS
+#define STATS_COUNT(stats, field, n) ((stats).field += (n))
+#define STATS_PEAK(stats, field, value) ((stats).field = std::max<size_t>((stats).field, (value)))
+#define STATS_TIME(stats, phase) ScopedPhaseTimer SEARCH_STATS_CONCAT(phaseTimer, __LINE__)((stats), (phase))
+#else
+#define STATS_COUNT(stats, field, n) ((void)(stats))
+#define STATS_PEAK(stats, field, value) ((void)(stats))
+#define STATS_TIME(stats, phase) ((void)(stats))
+#endif
+
+#endif
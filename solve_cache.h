@@ -0,0 +1,148 @@
+#ifndef SOLVE_CACHE_H
+#define SOLVE_CACHE_H
+
+#include <bits/stdc++.h>
+#include "batch.h"
+#include "closed_set.h"
+#include "packed_board.h"
+
+struct CacheCounters {
+    long long hits = 0;
+    long long subpathHits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+};
+
+// Optimal solutions of earlier queries, shared by every thread. A query is
+// answered when its start lies anywhere on a cached path to the same goal:
+// the rest of an optimal path is an optimal path from each of its states.
+// Only results known to be optimal are kept (status SOLVED, bound 1), so a
+// cached answer is right for any algorithm that asks. Capacity counts
+// solutions; the least recently used one is dropped first, together with
+// the states that lead into it.
+template <int N>
+class SolveCache {
+public:
+    explicit SolveCache(size_t solutions) : capacity(std::max<size_t>(solutions, 1)) {}
+
+    SolveCache(const SolveCache&) = delete;
+    SolveCache& operator=(const SolveCache&) = delete;
+
+    // Fills result and returns true on a hit.
+    bool lookup(const PackedBoard<N>& start, const PackedBoard<N>& goal, SolveResult& result) {
+        std::lock_guard<std::mutex> guard(lock);
+        typename Index::iterator found = index.find(Key{start.tiles, goal.tiles});
+        if (found == index.end()) {
+            counts.misses++;
+            return false;
+        }
+        typename Entries::iterator entry = found->second.entry;
+        entries.splice(entries.begin(), entries, entry);
+        size_t offset = found->second.offset;
+        counts.hits++;
+        counts.subpathHits += offset > 0;
+        result = SolveResult();
+        result.status = SOLVED;
+        result.moveCount = (int)(entry->path.size() - offset);
+        result.path = entry->path.substr(offset);
+        return true;
+    }
+
+    // Keeps result if it is an optimal solution of start to goal.
+    void store(const PackedBoard<N>& start, const PackedBoard<N>& goal, const SolveResult& result) {
+        if (result.status != SOLVED || result.bound != 1) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        if (index.count(Key{start.tiles, goal.tiles})) {
+            return;
+        }
+        entries.push_front(Entry{start, goal.tiles, result.path});
+        typename Entries::iterator entry = entries.begin();
+        forEachState(*entry, [&](Word tiles, size_t offset) {
+            index[Key{tiles, goal.tiles}] = Location{entry, offset};
+        });
+        while (entries.size() > capacity) {
+            evict(std::prev(entries.end()));
+        }
+    }
+
+    CacheCounters counters() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return counts;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return entries.size();
+    }
+
+private:
+    typedef typename PackedBoard<N>::Word Word;
+
+    struct Key {
+        Word state;
+        Word goal;
+
+        bool operator==(const Key& other) const {
+            return state == other.state && goal == other.goal;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return mixHash(key.state) ^ (mixHash(key.goal) * 0x9e3779b97f4a7c15ULL);
+        }
+    };
+
+    struct Entry {
+        PackedBoard<N> start;
+        Word goal;
+        std::string path;
+    };
+
+    typedef std::list<Entry> Entries;
+
+    struct Location {
+        typename Entries::iterator entry;
+        size_t offset;
+    };
+
+    typedef std::unordered_map<Key, Location, KeyHash> Index;
+
+    // Calls visit with every state on the entry's path but the goal, and the
+    // number of moves that lead to it.
+    template <class Visit>
+    static void forEachState(const Entry& entry, Visit visit) {
+        PackedBoard<N> board = entry.start;
+        for (size_t offset = 0; offset < entry.path.size(); ++offset) {
+            visit(board.tiles, offset);
+            char move = entry.path[offset];
+            int step = move == 'U' ? -N : move == 'D' ? N : move == 'L' ? -1 : 1;
+            board.applySlide(board.blank + step);
+        }
+        if (entry.path.empty()) {
+            visit(board.tiles, 0);
+        }
+    }
+
+    // States that a newer path has claimed stay indexed.
+    void evict(typename Entries::iterator entry) {
+        forEachState(*entry, [&](Word tiles, size_t) {
+            typename Index::iterator found = index.find(Key{tiles, entry->goal});
+            if (found != index.end() && found->second.entry == entry) {
+                index.erase(found);
+            }
+        });
+        entries.erase(entry);
+        counts.evictions++;
+    }
+
+    size_t capacity;
+    mutable std::mutex lock;
+    Entries entries;
+    Index index;
+    CacheCounters counts;
+};
+
+#endif
@@ -0,0 +1,412 @@
+#ifndef SOLVE_SERVER_H
+#define SOLVE_SERVER_H
+
+#include <bits/stdc++.h>
+#include "batch.h"
+#include "heuristics.h"
+#include "output.h"
+#include "packed_board.h"
+#include "pattern_database.h"
+#include "solve_cache.h"
+#include "solver.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// A long-lived solver that reads one request per line and answers each with
+// one line in the chosen output format, keeping pattern databases, heuristic
+// tables and node stores warm between requests. A request is the start and
+// goal boards, N * N numbers each, optionally followed by overrides of the
+// server's own options:
+//
+//   8 6 7 2 5 4 3 0 1 1 2 3 4 5 6 7 8 0 algorithm=ida max-nodes=100000
+//
+// Overrides are algorithm, heuristic, weight, max-nodes and time-limit,
+// with the values the command line takes. Blank lines and lines starting
+// with # are skipped. Requests are numbered from 1 on each connection and
+// answered by a pool of workers as soon as each finishes, so answers can
+// arrive out of order; the instance field says which request an answer is
+// for. A request that cannot be run is answered with status "error".
+
+template <int N>
+struct ServerRequest {
+    size_t instance;
+    PackedBoard<N> start;
+    PackedBoard<N> goal;
+    SolverConfig config;
+};
+
+// Returns false and describes the problem in error if line is not a valid
+// request.
+template <int N>
+bool parseRequest(const std::string& line, const PatternDatabase<N>* database, ServerRequest<N>& request,
+                  std::string& error) {
+    std::istringstream tokens(line);
+    std::vector<int> cells;
+    std::string token;
+    SolverConfig& config = request.config;
+    while (tokens >> token) {
+        size_t equals = token.find('=');
+        if (equals == std::string::npos) {
+            char* end;
+            long value = strtol(token.c_str(), &end, 10);
+            if (*end != '\0' || end == token.c_str()) {
+                error = "expected a number or name=value instead of " + token;
+                return false;
+            }
+            cells.push_back((int)value);
+            continue;
+        }
+        std::string name = token.substr(0, equals);
+        std::string value = token.substr(equals + 1);
+        bool valid = true;
+        if (name == "algorithm") {
+            valid = parseSearchAlgorithm(value, config.algorithm);
+        } else if (name == "heuristic") {
+            valid = parseHeuristicKind(value, config.heuristic);
+        } else if (name == "weight") {
+            valid = parseWeight(value, config.weight);
+        } else if (name == "max-nodes") {
+            config.budget.maxNodes = std::max(0LL, atoll(value.c_str()));
+        } else if (name == "time-limit") {
+            config.budget.seconds = std::max(0.0, atof(value.c_str()));
+        } else {
+            error = "unknown option " + name;
+            return false;
+        }
+        if (!valid) {
+            error = "invalid " + name + " " + value;
+            return false;
+        }
+    }
+    if (cells.size() != (size_t)(2 * N * N)) {
+        error = "expected " + std::to_string(2 * N * N) + " numbers";
+        return false;
+    }
+    if (!isValidBoard<N>(cells, 0) || !isValidBoard<N>(cells, N * N)) {
+        error = "a board is not a permutation of 0 to " + std::to_string(N * N - 1);
+        return false;
+    }
+    request.start = {0, 0};
+    request.goal = {0, 0};
+    for (int pos = 0; pos < N * N; ++pos) {
+        request.start.setTile(pos, cells[pos]);
+        request.goal.setTile(pos, cells[N * N + pos]);
+        if (cells[pos] == 0) {
+            request.start.blank = pos;
+        }
+        if (cells[N * N + pos] == 0) {
+            request.goal.blank = pos;
+        }
+    }
+    const PatternDatabase<N>* tables = config.heuristic == PATTERN_DATABASE ? database : nullptr;
+    if (!checkSolverConfig<N>(config, tables, error)) {
+        return false;
+    }
+    if (tables != nullptr && tables->builtForGoal() != request.goal) {
+        error = "the pattern database was built for a different goal state";
+        return false;
+    }
+    return true;
+}
+
+// Where the answers to one connection go. Workers finish in any order, so
+// each answer is sent in a single locked write.
+class ResponseChannel {
+public:
+    typedef std::function<bool(const std::string&)> Send;
+
+    explicit ResponseChannel(Send sender) : send(sender), open(true) {}
+
+    void write(const std::string& line) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (open) {
+            open = send(line);
+        }
+    }
+
+private:
+    Send send;
+    std::mutex lock;
+    bool open;
+};
+
+// Requests waiting for a worker. push blocks while the queue is full, so a
+// client that sends faster than the workers solve is slowed down rather
+// than buffered without bound.
+template <int N>
+class RequestQueue {
+public:
+    struct Job {
+        ServerRequest<N> request;
+        std::shared_ptr<ResponseChannel> channel;
+    };
+
+    explicit RequestQueue(size_t limit) : capacity(limit), closed(false) {}
+
+    void push(Job job) {
+        std::unique_lock<std::mutex> guard(lock);
+        notFull.wait(guard, [&] { return jobs.size() < capacity; });
+        jobs.push_back(std::move(job));
+        notEmpty.notify_one();
+    }
+
+    // Returns false once the queue is closed and empty.
+    bool pop(Job& job) {
+        std::unique_lock<std::mutex> guard(lock);
+        notEmpty.wait(guard, [&] { return !jobs.empty() || closed; });
+        if (jobs.empty()) {
+            return false;
+        }
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    std::mutex lock;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<Job> jobs;
+    bool closed;
+};
+
+// The worker pool and everything it shares. Each worker keeps its own
+// SolverContext for its whole life. The workers already use every thread
+// the server was given, so parallel A* requests run on one thread each.
+template <int N>
+class SolveServer {
+public:
+    SolveServer(const SolverConfig& serverDefaults, const PatternDatabase<N>* tables, SolveCache<N>* sharedCache,
+                OutputFormat outputFormat, int workers)
+        : defaults(serverDefaults), database(tables), cache(sharedCache), format(outputFormat),
+          queue(4 * (size_t)std::max(1, workers)) {
+        defaults.threads = 1;
+        for (int i = 0; i < std::max(1, workers); ++i) {
+            threads.emplace_back([this] { work(); });
+        }
+    }
+
+    SolveServer(const SolveServer&) = delete;
+    SolveServer& operator=(const SolveServer&) = delete;
+
+    // Waits for every queued request to be answered.
+    ~SolveServer() {
+        queue.close();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Reads requests with readLine until it returns false and queues them;
+    // their answers go to channel.
+    template <class ReadLine>
+    void serve(ReadLine readLine, const std::shared_ptr<ResponseChannel>& channel) {
+        std::string line;
+        size_t instance = 0;
+        while (readLine(line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') {
+                continue;
+            }
+            typename RequestQueue<N>::Job job;
+            job.request.instance = ++instance;
+            job.request.config = defaults;
+            job.channel = channel;
+            std::string error;
+            if (!parseRequest<N>(line, database, job.request, error)) {
+                std::ostringstream out;
+                writeError(format, out, instance, error);
+                channel->write(out.str());
+                continue;
+            }
+            queue.push(std::move(job));
+        }
+    }
+
+private:
+    void work() {
+        SolverContext<N> context;
+        typename RequestQueue<N>::Job job;
+        while (queue.pop(job)) {
+            Solver<N> solver(job.request.config, job.request.config.heuristic == PATTERN_DATABASE ? database : nullptr);
+            solver.useCache(cache);
+            SolveResult result = solver.solve(job.request.start, job.request.goal, context);
+            std::ostringstream out;
+            writeResult(format, out, job.request.instance, result);
+            job.channel->write(out.str());
+            job.channel.reset();
+        }
+    }
+
+    SolverConfig defaults;
+    const PatternDatabase<N>* database;
+    SolveCache<N>* cache;
+    OutputFormat format;
+    RequestQueue<N> queue;
+    std::vector<std::thread> threads;
+};
+
+// Serves standard input until it ends, answering on standard output.
+template <int N>
+void serveStandardInput(SolveServer<N>& server) {
+    std::shared_ptr<ResponseChannel> channel = std::make_shared<ResponseChannel>([](const std::string& line) {
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        return std::fflush(stdout) == 0;
+    });
+    server.serve([](std::string& line) { return (bool)std::getline(std::cin, line); }, channel);
+}
+
+#ifndef _WIN32
+// Splits what arrives on a socket into lines.
+class SocketLineReader {
+public:
+    explicit SocketLineReader(int connection) : socket(connection) {}
+
+    bool operator()(std::string& line) {
+        while (true) {
+            size_t end = pending.find('\n');
+            if (end != std::string::npos) {
+                line = pending.substr(0, end);
+                pending.erase(0, end + 1);
+                return true;
+            }
+            char buffer[1 << 16];
+            ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                // A last request without a newline still counts.
+                line.swap(pending);
+                pending.clear();
+                return !line.empty();
+            }
+            pending.append(buffer, (size_t)received);
+        }
+    }
+
+private:
+    int socket;
+    std::string pending;
+};
+
+inline bool sendAll(int socket, const std::string& data) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t count = send(socket, data.data() + sent, data.size() - sent, flags);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        sent += (size_t)count;
+    }
+    return true;
+}
+
+// Listens on a Unix domain socket at path and serves every connection on
+// its own reader thread, sharing the worker pool. A stale socket left at
+// path, one that refuses connections, is replaced; a socket that another
+// server still listens on, or any other file, is an error. Only returns, with
+// false and a description in error, if the socket cannot be set up or
+// accepting fails.
+template <int N>
+bool serveUnixSocket(SolveServer<N>& server, const std::string& path, std::string& error) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        error = "the socket path is too long";
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    struct stat existing;
+    if (lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            error = path + " exists and is not a socket";
+            return false;
+        }
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool stale =
+            probe >= 0 && connect(probe, (const sockaddr*)&address, sizeof(address)) != 0 && errno == ECONNREFUSED;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (!stale) {
+            error = path + " is already in use";
+            return false;
+        }
+        unlink(path.c_str());
+    }
+#ifndef MSG_NOSIGNAL
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, (const sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        error = std::string("cannot listen on ") + path + ": " + std::strerror(errno);
+        if (listener >= 0) {
+            close(listener);
+        }
+        return false;
+    }
+
+    // Readers are detached so that finished connections free their threads;
+    // active counts the ones still reading.
+    std::mutex lock;
+    std::condition_variable finished;
+    int active = 0;
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            error = std::string("cannot accept connections: ") + std::strerror(errno);
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            active++;
+        }
+        std::thread([&server, &lock, &finished, &active, client] {
+            // The channel closes the connection once the last answer is sent.
+            std::shared_ptr<ResponseChannel> channel(
+                new ResponseChannel([client](const std::string& line) { return sendAll(client, line); }),
+                [client](ResponseChannel* done) {
+                    delete done;
+                    close(client);
+                });
+            server.serve(SocketLineReader(client), channel);
+            std::lock_guard<std::mutex> guard(lock);
+            active--;
+            finished.notify_all();
+        }).detach();
+    }
+    close(listener);
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [&] { return active == 0; });
+    unlink(path.c_str());
+    return false;
+}
+#endif
+
+#endif
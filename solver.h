@@ -0,0 +1,417 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <bits/stdc++.h>
+#include "anytime_astar.h"
+#include "batch.h"
+#include "bidirectional_search.h"
+#include "closed_set.h"
+#include "distance_table.h"
+#include "external_search.h"
+#include "heuristics.h"
+#include "ida_star.h"
+#include "node_arena.h"
+#include "open_list.h"
+#include "packed_board.h"
+#include "parallel_astar.h"
+#include "pattern_database.h"
+#include "search_budget.h"
+#include "search_stats.h"
+#include "solve_cache.h"
+#include "thread_pool.h"
+
+enum SearchAlgorithm {
+    ASTAR_SEARCH,
+    GREEDY_SEARCH,
+    IDA_STAR_SEARCH,
+    PARALLEL_SEARCH,
+    BIDIRECTIONAL_SEARCH,
+    ANYTIME_SEARCH,
+    TABLE_SEARCH,
+    EXTERNAL_SEARCH
+};
+
+const char ALGORITHM_NAMES[] = "astar, greedy, ida, parallel, bidirectional, anytime, table or external";
+
+inline bool parseSearchAlgorithm(const std::string& name, SearchAlgorithm& algorithm) {
+    if (name == "astar") {
+        algorithm = ASTAR_SEARCH;
+    } else if (name == "greedy") {
+        algorithm = GREEDY_SEARCH;
+    } else if (name == "ida") {
+        algorithm = IDA_STAR_SEARCH;
+    } else if (name == "parallel") {
+        algorithm = PARALLEL_SEARCH;
+    } else if (name == "bidirectional") {
+        algorithm = BIDIRECTIONAL_SEARCH;
+    } else if (name == "anytime") {
+        algorithm = ANYTIME_SEARCH;
+    } else if (name == "table") {
+        algorithm = TABLE_SEARCH;
+    } else if (name == "external") {
+        algorithm = EXTERNAL_SEARCH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Whether an algorithm fills in SolveResult::stats. The others leave it
+// zero, which should not be reported as if it were measured.
+inline bool recordsSearchStats(SearchAlgorithm algorithm) {
+    return algorithm == ASTAR_SEARCH || algorithm == GREEDY_SEARCH || algorithm == BIDIRECTIONAL_SEARCH;
+}
+
+// How puzzles are solved. weight only applies to A*, where it is w in
+// f = g + w * h, and to ARA*, which starts from it; 0 leaves it to the
+// algorithm (see effectiveWeight). threads only applies to parallel A*.
+// The budget applies to every algorithm but table lookup.
+// Table lookup answers 3x3 boards from precomputed distances and ignores the
+// heuristic. External search keeps its layers in files under
+// scratchDirectory (the system's temporary directory if empty) and treats
+// the memory budget as its RAM cap.
+struct SolverConfig {
+    SearchAlgorithm algorithm = ASTAR_SEARCH;
+    HeuristicKind heuristic = MANHATTAN_DISTANCE;
+    OpenListKind openList = BUCKET_OPEN_LIST;
+    int weight = 0;
+    int threads = defaultThreadCount();
+    SearchBudget budget;
+    std::string scratchDirectory;
+};
+
+// The weight config asks for, or the algorithm's default: plain A* for A*,
+// and DEFAULT_ANYTIME_WEIGHT for ARA*. ARA* given 1 runs plain A*.
+inline int effectiveWeight(const SolverConfig& config) {
+    if (config.weight != 0) {
+        return config.weight;
+    }
+    return config.algorithm == ANYTIME_SEARCH ? DEFAULT_ANYTIME_WEIGHT : WEIGHT_SCALE;
+}
+
+// Returns false and describes the problem in error if config cannot solve
+// N x N boards with the given pattern database (which may be null).
+template <int N>
+bool checkSolverConfig(const SolverConfig& config, const PatternDatabase<N>* database, std::string& error) {
+    if (config.algorithm == TABLE_SEARCH && N != 3) {
+        error = "the distance table only covers 3x3 boards";
+    } else if (!heuristicSupported<N>(config.heuristic)) {
+        error = "that heuristic is not available for " + std::to_string(N) + "x" + std::to_string(N) + " boards";
+    } else if (config.heuristic == PATTERN_DATABASE && database == nullptr) {
+        error = "the pdb heuristic needs a pattern database";
+    } else if (config.weight != 0 && config.algorithm != ASTAR_SEARCH && config.algorithm != ANYTIME_SEARCH) {
+        error = "a weight only applies to A* and ARA*";
+    } else if (config.algorithm == EXTERNAL_SEARCH && !config.scratchDirectory.empty() &&
+               !std::filesystem::is_directory(config.scratchDirectory)) {
+        error = "the scratch directory " + config.scratchDirectory + " does not exist";
+    } else if (config.heuristic == PATTERN_DATABASE && config.algorithm == BIDIRECTIONAL_SEARCH) {
+        error = "bidirectional search needs a heuristic towards the initial state; a pattern database only has one for "
+                "its goal";
+    } else {
+        return true;
+    }
+    return false;
+}
+
+template <int N>
+struct Puzzle {
+    PackedBoard<N> cells;
+    int heuristicValue;
+    int moveCount;
+    uint32_t parent;
+    char move;
+
+    Puzzle(const PackedBoard<N>& c, int h, int m, uint32_t p, char mv)
+        : cells(c), heuristicValue(h), moveCount(m), parent(p), move(mv) {}
+};
+
+// One state expanded by A* or greedy search, in expansion order.
+template <int N>
+struct TraceStep {
+    PackedBoard<N> board;
+    int heuristic;
+};
+
+template <int N>
+void generateSuccessors(const Puzzle<N>& currentPuzzle, uint32_t parent, const Heuristic<N>& heuristic,
+                        NodeArena<Puzzle<N>>& successors, SearchStats& stats) {
+    const MoveTable<N>& table = moveTable<N>();
+    int blank = currentPuzzle.cells.blank;
+
+    for (int k = 0; k < table.count[blank]; ++k) {
+        int from = table.target[blank][k];
+        int tile = currentPuzzle.cells.tileAt(from);
+        PackedBoard<N> newCells = currentPuzzle.cells.slide(from);
+        int h;
+        {
+            STATS_TIME(stats, HEURISTIC_PHASE);
+            h = heuristic.update(newCells, currentPuzzle.heuristicValue, tile, from, blank);
+        }
+        int m = currentPuzzle.moveCount + 1;
+        successors.allocate(Puzzle<N>(newCells, h, m, parent, moveName<N>(blank, from)));
+    }
+}
+
+template <int N, class OpenList>
+using PuzzleWorkspace = SearchWorkspace<N, Puzzle<N>, OpenList>;
+
+// Best-first search. A* orders on f = g + w * h, preferring deeper nodes on
+// ties, with w = effectiveWeight(config) / WEIGHT_SCALE; above 1, the
+// solution is at most w times as long as an optimal one. Greedy search
+// orders on h alone and gives no bound (reported as 0). Stops with the best
+// partial path when the budget runs out. If trace is given, every expanded
+// state is appended to it.
+template <int N, class OpenList>
+SolveResult searchPuzzle(const PackedBoard<N>& initial, const PackedBoard<N>& goal, const Heuristic<N>& heuristic,
+                         const SolverConfig& config, std::vector<TraceStep<N>>* trace,
+                         PuzzleWorkspace<N, OpenList>& workspace) {
+    workspace.clear();
+    OpenList& openList = workspace.openList;
+    NodeArena<Puzzle<N>>& nodes = workspace.nodes;
+    ClosedSet<N>& visited = workspace.visited;
+    SolveResult result;
+    SearchStats& stats = result.stats;
+    BudgetMonitor monitor(config.budget);
+    bool greedy = config.algorithm == GREEDY_SEARCH;
+    int weight = effectiveWeight(config);
+    uint32_t closest = 0;
+
+    int h = heuristic.evaluate(initial);
+    nodes.allocate(Puzzle<N>(initial, h, 0, NO_PARENT, 0));
+    openList.push(0, greedy ? h : weight * h, 0);
+
+    while (!openList.empty()) {
+        uint32_t index;
+        {
+            STATS_TIME(stats, QUEUE_PHASE);
+            index = openList.pop();
+        }
+        const Puzzle<N>& current = nodes[index];
+
+        if (current.cells == goal) {
+            result.status = SOLVED;
+            result.moveCount = current.moveCount;
+            result.path = reconstructPath(nodes, index);
+            result.bound = greedy ? 0 : weightValue(weight);
+            return result;
+        }
+
+        bool unvisited;
+        {
+            STATS_TIME(stats, CLOSED_SET_PHASE);
+            unvisited = visited.insert(current.cells);
+        }
+        if (unvisited) {
+            result.expandedNodes++;
+            if (current.heuristicValue < nodes[closest].heuristicValue) {
+                closest = index;
+            }
+            uint32_t first = nodes.size();
+            {
+                STATS_TIME(stats, SUCCESSOR_PHASE);
+                generateSuccessors(current, index, heuristic, nodes, stats);
+            }
+            STATS_COUNT(stats, generated, nodes.size() - first);
+            for (uint32_t i = first; i < nodes.size(); ++i) {
+                STATS_TIME(stats, QUEUE_PHASE);
+                if (greedy) {
+                    openList.push(i, nodes[i].heuristicValue, 0);
+                } else {
+                    openList.push(i, weight * nodes[i].heuristicValue + WEIGHT_SCALE * nodes[i].moveCount,
+                                  nodes[i].moveCount);
+                }
+            }
+            STATS_PEAK(stats, peakOpen, openList.size());
+            STATS_PEAK(stats, peakClosed, visited.size());
+            if (trace != nullptr) {
+                trace->push_back(TraceStep<N>{current.cells, current.heuristicValue});
+            }
+        } else {
+            STATS_COUNT(stats, duplicates, 1);
+        }
+
+        if (monitor.exhausted(result.expandedNodes, [&] { return workspace.memoryBytes(); }, result.budgetLimit)) {
+            result.status = BUDGET_EXCEEDED;
+            result.moveCount = nodes[closest].moveCount;
+            result.path = reconstructPath(nodes, closest);
+            result.remainingEstimate = nodes[closest].heuristicValue;
+            return result;
+        }
+    }
+
+    return result;
+}
+
+// What a thread keeps between solves: the node stores, open lists and
+// closed sets of the best-first searches and ARA*, and the heuristic for
+// the last goal. Each is created on first use and afterwards only cleared,
+// so a warm context solves without allocating. Contexts are not shared
+// between threads; keep one per thread.
+template <int N>
+class SolverContext {
+public:
+    SolverContext() : heuristicKind(MANHATTAN_DISTANCE), heuristicGoal{0, 0}, heuristicDatabase(nullptr) {}
+
+    SolverContext(const SolverContext&) = delete;
+    SolverContext& operator=(const SolverContext&) = delete;
+
+    PuzzleWorkspace<N, BucketOpenList>& bucketWorkspace() {
+        if (!bucket) {
+            bucket.reset(new PuzzleWorkspace<N, BucketOpenList>());
+        }
+        return *bucket;
+    }
+
+    PuzzleWorkspace<N, HeapOpenList>& heapWorkspace() {
+        if (!heap) {
+            heap.reset(new PuzzleWorkspace<N, HeapOpenList>());
+        }
+        return *heap;
+    }
+
+    AnytimeAStar<N>& anytimeSearch() {
+        if (!anytime) {
+            anytime.reset(new AnytimeAStar<N>());
+        }
+        return *anytime;
+    }
+
+    // Built again only when the kind, goal or database differs from the
+    // previous call.
+    const Heuristic<N>& heuristic(HeuristicKind kind, const PackedBoard<N>& goal, const PatternDatabase<N>* database) {
+        if (!cachedHeuristic || kind != heuristicKind || goal != heuristicGoal || database != heuristicDatabase) {
+            cachedHeuristic.reset(new Heuristic<N>(kind, goal, database));
+            heuristicKind = kind;
+            heuristicGoal = goal;
+            heuristicDatabase = database;
+        }
+        return *cachedHeuristic;
+    }
+
+private:
+    std::unique_ptr<PuzzleWorkspace<N, BucketOpenList>> bucket;
+    std::unique_ptr<PuzzleWorkspace<N, HeapOpenList>> heap;
+    std::unique_ptr<AnytimeAStar<N>> anytime;
+    std::unique_ptr<Heuristic<N>> cachedHeuristic;
+    HeuristicKind heuristicKind;
+    PackedBoard<N> heuristicGoal;
+    const PatternDatabase<N>* heuristicDatabase;
+};
+
+// Solves N x N puzzles with one configuration. A Solver holds no search
+// state, so threads can share one as long as each passes its own context.
+//
+//     SolverConfig config;
+//     config.algorithm = IDA_STAR_SEARCH;
+//     Solver<4> solver(config);
+//     SolverContext<4> context;
+//     SolveResult result = solver.solve(start, goal, context);
+template <int N>
+class Solver {
+public:
+    typedef std::function<void(const SolveResult&)> Improvement;
+
+    // Check config with checkSolverConfig first. A pattern database must
+    // outlive the solver and have been built for every goal it is given.
+    explicit Solver(const SolverConfig& solverConfig, const PatternDatabase<N>* tables = nullptr)
+        : config(solverConfig), database(tables), cache(nullptr) {}
+
+    // Answers repeated queries from cache, which must outlive the solver and
+    // may be shared with other solvers. Traced solves always search.
+    void useCache(SolveCache<N>* shared) {
+        cache = shared;
+    }
+
+    const SolverConfig& configuration() const {
+        return config;
+    }
+
+    // Reports NOT_SOLVABLE without searching when goal cannot be reached,
+    // and the time taken in result.seconds. trace, if given, receives the
+    // states A* and greedy search expand; improved sees every better
+    // solution ARA* finds.
+    SolveResult solve(const PackedBoard<N>& start, const PackedBoard<N>& goal, SolverContext<N>& context,
+                      std::vector<TraceStep<N>>* trace = nullptr, const Improvement& improved = Improvement()) const {
+        std::chrono::steady_clock::time_point began = std::chrono::steady_clock::now();
+        SolveResult result;
+        if (permutationParity(start) != permutationParity(goal)) {
+            result.status = NOT_SOLVABLE;
+        } else if (cache == nullptr || trace != nullptr || !cache->lookup(start, goal, result)) {
+            result = search(start, goal, context, trace, improved);
+            if (cache != nullptr) {
+                cache->store(start, goal, result);
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+        return result;
+    }
+
+private:
+    SolveResult search(const PackedBoard<N>& start, const PackedBoard<N>& goal, SolverContext<N>& context,
+                       std::vector<TraceStep<N>>* trace, const Improvement& improved) const {
+        if (config.algorithm == TABLE_SEARCH) {
+            return solveFromTable(start, goal);
+        }
+        const Heuristic<N>& heuristic = context.heuristic(config.heuristic, goal, database);
+        SolveResult result;
+        switch (config.algorithm) {
+        case IDA_STAR_SEARCH: {
+            IdaStar<N> search(heuristic);
+            IdaStarResult ida = search.solve(start, goal, config.budget);
+            result.status = ida.solved ? SOLVED : BUDGET_EXCEEDED;
+            result.moveCount = ida.moveCount;
+            result.path = ida.path;
+            result.expandedNodes = ida.expandedNodes;
+            result.budgetLimit = ida.budgetLimit;
+            result.remainingEstimate = ida.remainingEstimate;
+            return result;
+        }
+        case PARALLEL_SEARCH: {
+            ParallelAStar<N> search(heuristic, config.threads);
+            ParallelAStarResult parallel = search.solve(start, goal, config.budget);
+            result.status = parallel.solved ? SOLVED : parallel.budgetExceeded ? BUDGET_EXCEEDED : NO_SOLUTION;
+            result.moveCount = parallel.moveCount;
+            result.path = parallel.path;
+            result.expandedNodes = parallel.expandedNodes;
+            result.budgetLimit = parallel.budgetLimit;
+            result.remainingEstimate = parallel.remainingEstimate;
+            return result;
+        }
+        case BIDIRECTIONAL_SEARCH: {
+            // The backward half estimates the distance to the initial state
+            // with the same kind of heuristic.
+            Heuristic<N> towardsStart(config.heuristic, start);
+            BidirectionalSearch<N> search(heuristic, towardsStart);
+            BidirectionalResult bidirectional = search.solve(start, goal, config.budget);
+            result.status =
+                bidirectional.solved ? SOLVED : bidirectional.budgetExceeded ? BUDGET_EXCEEDED : NO_SOLUTION;
+            result.moveCount = bidirectional.moveCount;
+            result.path = bidirectional.path;
+            result.expandedNodes = bidirectional.expandedNodes;
+            result.budgetLimit = bidirectional.budgetLimit;
+            result.remainingEstimate = bidirectional.remainingEstimate;
+            result.stats = bidirectional.stats;
+            return result;
+        }
+        case EXTERNAL_SEARCH: {
+            ExternalSearch<N> search(heuristic, config.scratchDirectory);
+            return search.solve(start, goal, config.budget);
+        }
+        case ANYTIME_SEARCH: {
+            return context.anytimeSearch().solve(heuristic, start, goal, effectiveWeight(config), config.budget,
+                                                 improved);
+        }
+        default:
+            if (config.openList == HEAP_OPEN_LIST) {
+                return searchPuzzle<N, HeapOpenList>(start, goal, heuristic, config, trace, context.heapWorkspace());
+            }
+            return searchPuzzle<N, BucketOpenList>(start, goal, heuristic, config, trace, context.bucketWorkspace());
+        }
+    }
+
+    SolverConfig config;
+    const PatternDatabase<N>* database;
+    SolveCache<N>* cache;
+};
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef SOLVER_CLI_H
+#define SOLVER_CLI_H
+
+#include <bits/stdc++.h>
+#include "batch.h"
+#include "generator.h"
+#include "heuristics.h"
+#include "output.h"
+#include "packed_board.h"
+#include "pattern_database.h"
+#include "solve_server.h"
+#include "solver.h"
+
+// The command line shared by the solver programs, which differ only in the
+// algorithm and heuristic they use by default. One puzzle is read from
+// standard input unless --batch is given.
+//
+//   --size 3|4|5             board size (default 3)
+//   --algorithm NAME         astar, greedy, ida, parallel, bidirectional,
+//                            anytime, table (3x3 only) or external; --ida,
+//                            --parallel, --bidirectional and --anytime are
+//                            shorthands
+//   --heuristic NAME         see HEURISTIC_NAMES; pdb needs --pdb FILE
+//   --open-list bucket|heap  open list for A* and greedy search
+//   --weight W               w in f = g + w * h for A* (default 1), or
+//                            ARA*'s first w (default 3)
+//   --max-nodes K            budgets; --max-iterations is the old name of
+//   --time-limit SECONDS     --max-nodes
+//   --memory-limit MB        for external search, its RAM cap instead
+//   --scratch-dir DIR        where external search keeps its layer files
+//   --batch FILE|-           solve every instance in the file
+//   --cache ENTRIES          answer repeated batch instances or requests
+//                            from a cache of that many optimal solutions
+//   --serve                  answer requests from standard input until it
+//                            ends, one per line (see solve_server.h)
+//   --socket PATH            answer requests from connections to a Unix
+//                            domain socket at PATH
+//   --threads T              batch or server workers, or parallel A*
+//                            threads outside the server
+//   --seed S                 for replacing an unsolvable puzzle
+//   --verbosity silent|summary|trace
+//   --format text|json|csv
+
+const int DEFAULT_PUZZLE_SIZE = 3;
+
+struct SolverOptions {
+    SolverConfig config;
+    std::string patternDatabase;
+    std::string batchFile;
+    Verbosity verbosity = SUMMARY;
+    OutputFormat format = TEXT_OUTPUT;
+    uint64_t seed = DEFAULT_SEED;
+    size_t cacheEntries = 0;
+    bool serve = false;
+    std::string socketPath;
+};
+
+template <int N>
+void printPuzzle(const PackedBoard<N>& cells, std::ostream& out) {
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            int value = cells.tileAt(i * N + j);
+            if (value == 0) {
+                out << "  ";
+            } else {
+                out << value << " ";
+            }
+        }
+        out << '\n';
+    }
+}
+
+template <int N>
+bool isSolvable(const std::vector<std::vector<int>>& initialPuzzle, const std::vector<std::vector<int>>& goalPuzzle) {
+    return permutationParity(packBoard<N>(initialPuzzle)) == permutationParity(packBoard<N>(goalPuzzle));
+}
+
+template <int N>
+std::vector<std::vector<int>> generateRandomPuzzle(const std::vector<std::vector<int>>& goalPuzzle,
+                                                   std::mt19937_64& rng) {
+    return unpackBoard<N>(randomSolvableBoard<N>(rng, packBoard<N>(goalPuzzle)));
+}
+
+template <int N>
+void reportResult(const SolveResult& result, const PackedBoard<N>& goal, const SolverOptions& options,
+                  OutputBuffer& out) {
+    if (options.verbosity == SILENT) {
+        return;
+    }
+    if (options.format != TEXT_OUTPUT) {
+        if (options.format == CSV_OUTPUT) {
+            writeCsvHeader(out.stream());
+        }
+        writeResult(options.format, out.stream(), 1, result);
+        return;
+    }
+    if (result.status == SOLVED) {
+        out.stream() << "Goal state reached in " << result.moveCount << " moves.\n";
+        out.stream() << "Moves: " << result.path << '\n';
+        if (result.bound > 1) {
+            out.stream() << std::fixed << std::setprecision(2) << "At most " << result.bound
+                         << " times the optimal length.\n";
+        }
+        out.stream() << "Nodes expanded: " << result.expandedNodes << '\n';
+        out.stream() << "Goal state:\n";
+        printPuzzle(goal, out.stream());
+    } else if (result.status == NOT_SOLVABLE) {
+        out.stream() << "The puzzle is not solvable.\n";
+    } else if (result.status == BUDGET_EXCEEDED) {
+        out.stream() << "Stopped by the " << budgetName(result.budgetLimit) << " budget after " << result.expandedNodes
+                     << " nodes expanded.\n";
+        out.stream() << "Best partial path: " << result.moveCount << " moves (" << result.path << "), estimated "
+                     << result.remainingEstimate << " more to the goal.\n";
+    } else {
+        out.stream() << "No solution found.\n";
+    }
+#ifdef PUZZLE_STATS
+    if (result.status != NOT_SOLVABLE && recordsSearchStats(options.config.algorithm)) {
+        writeSearchStats(out.stream(), result.stats);
+    }
+#endif
+}
+
+// An unsolvable puzzle is replaced by a random solvable one for the same
+// goal. At trace verbosity, A* and greedy search print every state they
+// expand and ARA* every solution it improves on.
+template <int N>
+void solvePuzzle(const std::vector<std::vector<int>>& initialPuzzle, const std::vector<std::vector<int>>& goalPuzzle,
+                 const Solver<N>& solver, const SolverOptions& options, SolverContext<N>& context, std::mt19937_64& rng,
+                 OutputBuffer& out) {
+    bool narrate = options.verbosity != SILENT && options.format == TEXT_OUTPUT;
+    if (!isSolvable<N>(initialPuzzle, goalPuzzle)) {
+        if (narrate) {
+            out.stream() << "The puzzle is not solvable. Generating a random initial state.\n";
+        }
+        solvePuzzle<N>(generateRandomPuzzle<N>(goalPuzzle, rng), goalPuzzle, solver, options, context, rng, out);
+        return;
+    }
+
+    PackedBoard<N> goal = packBoard<N>(goalPuzzle);
+    std::vector<TraceStep<N>> trace;
+    bool tracing = options.verbosity == TRACE && options.format == TEXT_OUTPUT;
+    SolveResult result = solver.solve(packBoard<N>(initialPuzzle), goal, context, tracing ? &trace : nullptr,
+                                      [&](const SolveResult& found) {
+        if (tracing) {
+            out.stream() << "Found " << found.moveCount << " moves after " << found.expandedNodes
+                         << " nodes expanded, at most " << std::fixed << std::setprecision(2) << found.bound
+                         << " times the optimal length.\n";
+        }
+    });
+    for (const TraceStep<N>& step : trace) {
+        out.stream() << "Moved to state (heuristic cost: " << step.heuristic << "):\n";
+        printPuzzle(step.board, out.stream());
+    }
+    reportResult<N>(result, goal, options, out);
+}
+
+// Reads one instance from standard input and solves it. Input that is not
+// two permutations of 0 to N * N - 1 is rejected, as in batch mode.
+template <int N>
+int runPuzzle(const SolverOptions& options, const Solver<N>& solver, const PatternDatabase<N>& database) {
+    std::vector<std::vector<int>> initialPuzzle(N, std::vector<int>(N));
+    std::vector<std::vector<int>> goalPuzzle(N, std::vector<int>(N));
+
+    bool prompt = options.verbosity != SILENT && options.format == TEXT_OUTPUT;
+    if (prompt) {
+        std::cout << "Enter the initial state (use 0 for the blank space): " << std::endl;
+    }
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            std::cin >> initialPuzzle[i][j];
+        }
+    }
+
+    if (prompt) {
+        std::cout << "Enter the goal state (use 0 for the blank space): " << std::endl;
+    }
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            std::cin >> goalPuzzle[i][j];
+        }
+    }
+
+    if (!std::cin) {
+        std::cout << "Expected " << 2 * N * N << " numbers: the initial and the goal state." << std::endl;
+        return 1;
+    }
+    std::vector<int> cells;
+    for (const std::vector<std::vector<int>>* puzzle : {&initialPuzzle, &goalPuzzle}) {
+        for (const std::vector<int>& row : *puzzle) {
+            cells.insert(cells.end(), row.begin(), row.end());
+        }
+    }
+    if (!isValidBoard<N>(cells, 0) || !isValidBoard<N>(cells, N * N)) {
+        std::cout << "A state is not a permutation of 0 to " << N * N - 1 << "." << std::endl;
+        return 1;
+    }
+    if (options.config.heuristic == PATTERN_DATABASE && database.builtForGoal() != packBoard<N>(goalPuzzle)) {
+        std::cout << "The pattern database was built for a different goal state." << std::endl;
+        return 1;
+    }
+
+    OutputBuffer out;
+    std::mt19937_64 rng(options.seed);
+    SolverContext<N> context;
+    solvePuzzle<N>(initialPuzzle, goalPuzzle, solver, options, context, rng, out);
+    out.flush();
+    return 0;
+}
+
+// Solves every instance in the batch file and prints one line per instance,
+// in input order. Tracing is not available in batch mode.
+template <int N>
+int runBatch(const SolverOptions& options, const Solver<N>& solver, const PatternDatabase<N>& database,
+             const SolveCache<N>* cache) {
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (options.batchFile != "-") {
+        file.open(options.batchFile);
+        if (!file) {
+            std::cout << "Cannot read " << options.batchFile << std::endl;
+            return 1;
+        }
+        in = &file;
+    }
+    std::vector<BatchInstance<N>> instances;
+    std::string error;
+    if (!readBatch<N>(*in, instances, error)) {
+        std::cout << "Cannot read the batch: " << error << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < instances.size(); ++i) {
+        if (options.config.heuristic == PATTERN_DATABASE && database.builtForGoal() != instances[i].goal) {
+            std::cout << "The pattern database was built for a different goal state than instance " << i + 1 << "."
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // A parallel search already uses every thread, so instances then run one
+    // at a time.
+    int threads = options.config.algorithm == PARALLEL_SEARCH ? 1 : options.config.threads;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<SolveResult> results = solveBatch<SolverContext<N>>(instances, threads,
+        [&](const BatchInstance<N>& instance, SolverContext<N>& context) {
+            return solver.solve(instance.initial, instance.goal, context);
+        });
+    writeBatchResults(results, options.format, options.verbosity, options.config.threads,
+                      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    if (cache != nullptr && options.verbosity != SILENT && options.format == TEXT_OUTPUT) {
+        CacheCounters counters = cache->counters();
+        std::cout << "Cache: " << counters.hits << " hits (" << counters.subpathHits << " on subpaths), "
+                  << counters.misses << " misses, " << counters.evictions << " evictions." << std::endl;
+    }
+    return 0;
+}
+
+// Serves requests until standard input ends or, with a socket, until
+// accepting connections fails. The options are every request's defaults.
+template <int N>
+int runServer(const SolverOptions& options, const PatternDatabase<N>* database) {
+    std::unique_ptr<SolveCache<N>> cache;
+    if (options.cacheEntries > 0) {
+        cache.reset(new SolveCache<N>(options.cacheEntries));
+    }
+    SolveServer<N> server(options.config, database, cache.get(), options.format, options.config.threads);
+    if (options.socketPath.empty()) {
+        serveStandardInput<N>(server);
+        return 0;
+    }
+#ifdef _WIN32
+    std::cout << "Unix domain sockets are not supported on this platform; use --serve." << std::endl;
+    return 1;
+#else
+    std::string error;
+    serveUnixSocket<N>(server, options.socketPath, error);
+    std::cout << "Cannot serve: " << error << std::endl;
+    return 1;
+#endif
+}
+
+template <int N>
+int runSolver(const SolverOptions& options) {
+    PatternDatabase<N> database;
+    std::string error;
+    // A server opens a given database even if it is not the default, so
+    // that requests can ask for it.
+    bool openDatabase =
+        options.config.heuristic == PATTERN_DATABASE || (options.serve && !options.patternDatabase.empty());
+    if (openDatabase && !database.open(options.patternDatabase, error)) {
+        std::cout << "Cannot use pattern database: " << error << std::endl;
+        return 1;
+    }
+    const PatternDatabase<N>* tables = options.config.heuristic == PATTERN_DATABASE ? &database : nullptr;
+    if (!checkSolverConfig<N>(options.config, tables, error)) {
+        std::cout << "Cannot solve with these options: " << error << "." << std::endl;
+        return 1;
+    }
+    if (options.serve) {
+        return runServer<N>(options, openDatabase ? &database : nullptr);
+    }
+    Solver<N> solver(options.config, tables);
+    if (!options.batchFile.empty()) {
+        std::unique_ptr<SolveCache<N>> cache;
+        if (options.cacheEntries > 0) {
+            cache.reset(new SolveCache<N>(options.cacheEntries));
+            solver.useCache(cache.get());
+        }
+        return runBatch<N>(options, solver, database, cache.get());
+    }
+    return runPuzzle<N>(options, solver, database);
+}
+
+// Parses the command line over the program's defaults and runs the solver.
+inline int runSolverCli(int argc, char* argv[], const SolverConfig& defaults) {
+    int size = DEFAULT_PUZZLE_SIZE;
+    SolverOptions options;
+    options.config = defaults;
+    SolverConfig& config = options.config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (arg == "--algorithm" && i + 1 < argc) {
+            if (!parseSearchAlgorithm(argv[++i], config.algorithm)) {
+                std::cout << "Unknown algorithm " << argv[i] << " (expected " << ALGORITHM_NAMES << ")." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--ida") {
+            config.algorithm = IDA_STAR_SEARCH;
+        } else if (arg == "--parallel") {
+            config.algorithm = PARALLEL_SEARCH;
+        } else if (arg == "--bidirectional") {
+            config.algorithm = BIDIRECTIONAL_SEARCH;
+        } else if (arg == "--anytime") {
+            config.algorithm = ANYTIME_SEARCH;
+        } else if (arg == "--heuristic" && i + 1 < argc) {
+            if (!parseHeuristicKind(argv[++i], config.heuristic)) {
+                std::cout << "Unknown heuristic " << argv[i] << " (expected " << HEURISTIC_NAMES << ")." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--pdb" && i + 1 < argc) {
+            options.patternDatabase = argv[++i];
+        } else if (arg == "--open-list" && i + 1 < argc) {
+            if (!parseOpenListKind(argv[++i], config.openList)) {
+                std::cout << "Unknown open list " << argv[i] << " (expected bucket or heap)." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--weight" && i + 1 < argc) {
+            if (!parseWeight(argv[++i], config.weight)) {
+                std::cout << "The weight must be a number from 1 to 100." << std::endl;
+                return 1;
+            }
+        } else if ((arg == "--max-nodes" || arg == "--max-iterations") && i + 1 < argc) {
+            config.budget.maxNodes = std::max(0LL, atoll(argv[++i]));
+        } else if (arg == "--time-limit" && i + 1 < argc) {
+            config.budget.seconds = std::max(0.0, atof(argv[++i]));
+        } else if (arg == "--memory-limit" && i + 1 < argc) {
+            config.budget.memoryBytes = (size_t)std::max(0LL, atoll(argv[++i])) << 20;
+        } else if (arg == "--serve") {
+            options.serve = true;
+        } else if (arg == "--socket" && i + 1 < argc) {
+            options.serve = true;
+            options.socketPath = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cacheEntries = (size_t)std::max(0LL, atoll(argv[++i]));
+        } else if (arg == "--scratch-dir" && i + 1 < argc) {
+            config.scratchDirectory = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            options.batchFile = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--verbosity" && i + 1 < argc) {
+            if (!parseVerbosity(argv[++i], options.verbosity)) {
+                std::cout << "Unknown verbosity " << argv[i] << " (expected silent, summary or trace)." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--format" && i + 1 < argc) {
+            if (!parseOutputFormat(argv[++i], options.format)) {
+                std::cout << "Unknown format " << argv[i] << " (expected text, json or csv)." << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    if (config.heuristic == PATTERN_DATABASE && options.patternDatabase.empty()) {
+        std::cout << "The pdb heuristic needs --pdb FILE (see pdb-builder)." << std::endl;
+        return 1;
+    }
+
+    switch (size) {
+    case 3:
+        return runSolver<3>(options);
+    case 4:
+        return runSolver<4>(options);
+    case 5:
+        return runSolver<5>(options);
+    default:
+        std::cout << "Unsupported board size " << size << " (expected 3, 4 or 5)." << std::endl;
+        return 1;
+    }
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <bits/stdc++.h>
+
+inline int defaultThreadCount() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : (int)count;
+}
+
+// Runs a fixed set of independent tasks, numbered 0 to count - 1, on a group
+// of threads. Each worker starts with a contiguous block of task numbers and
+// takes them from the front of its own queue; once that is empty it steals
+// from the back of the other workers' queues. Solve times vary by orders of
+// magnitude between instances, so a static split alone leaves cores idle.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int threads) : threadCount(std::max(1, threads)) {}
+
+    int threads() const {
+        return threadCount;
+    }
+
+    // Calls task(index, worker) once for every index and returns when all
+    // calls have finished. worker is in [0, threads()) and identifies the
+    // calling thread, so tasks can keep per-worker state without locking.
+    template <class Task>
+    void run(size_t count, Task task) {
+        std::vector<Queue> queues(threadCount);
+        for (size_t i = 0; i < count; ++i) {
+            queues[i * threadCount / count].items.push_back(i);
+        }
+
+        auto work = [&](int worker) {
+            size_t index;
+            while (take(queues, worker, index)) {
+                task(index, worker);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int worker = 1; worker < threadCount; ++worker) {
+            workers.emplace_back(work, worker);
+        }
+        work(0);
+        for (std::thread& thread : workers) {
+            thread.join();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<size_t> items;
+    };
+
+    // No task adds work, so a worker that finds every queue empty is done.
+    static bool take(std::vector<Queue>& queues, int worker, size_t& index) {
+        {
+            Queue& own = queues[worker];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (!own.items.empty()) {
+                index = own.items.front();
+                own.items.pop_front();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); ++k) {
+            Queue& victim = queues[(worker + k) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.items.empty()) {
+                index = victim.items.back();
+                victim.items.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int threadCount;
+};
+
+#endif
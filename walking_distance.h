@@ -0,0 +1,169 @@
+#ifndef WALKING_DISTANCE_H
+#define WALKING_DISTANCE_H
+
+#include <bits/stdc++.h>
+#include "closed_set.h"
+#include "goal_table.h"
+#include "packed_board.h"
+
+// Walking distance (Takahashi): forget which column a tile is in and keep,
+// for every row, how many of its tiles belong to each goal row. A vertical
+// move carries one tile across a row boundary, so the number of such moves
+// is at least the BFS distance between the two count matrices. The same
+// table, built on goal columns, bounds the horizontal moves, and the two
+// bounds add up.
+//
+// A count matrix is keyed with 3 bits per entry; the blank's row is the only
+// one whose counts sum to N - 1, so it needs no field of its own.
+template <int N>
+class WalkingDistanceTable {
+public:
+    typedef typename BoardTraits<N>::Word Key;
+
+    // Builds the table for goals whose blank sits in line goalBlankLine.
+    explicit WalkingDistanceTable(int goalBlankLine) {
+        int counts[N][N] = {};
+        for (int line = 0; line < N; ++line) {
+            counts[line][line] = line == goalBlankLine ? N - 1 : N;
+        }
+        std::vector<Key> frontier(1, encode(counts));
+        distances[frontier[0]] = 0;
+
+        for (int depth = 0; !frontier.empty(); ++depth) {
+            std::vector<Key> next;
+            for (Key key : frontier) {
+                int blankLine = decode(key, counts);
+                for (int neighbour = blankLine - 1; neighbour <= blankLine + 1; neighbour += 2) {
+                    if (neighbour < 0 || neighbour >= N) {
+                        continue;
+                    }
+                    for (int goalLine = 0; goalLine < N; ++goalLine) {
+                        if (counts[neighbour][goalLine] == 0) {
+                            continue;
+                        }
+                        counts[neighbour][goalLine]--;
+                        counts[blankLine][goalLine]++;
+                        Key moved = encode(counts);
+                        if (distances.find(moved) == distances.end()) {
+                            distances[moved] = depth + 1;
+                            next.push_back(moved);
+                        }
+                        counts[blankLine][goalLine]--;
+                        counts[neighbour][goalLine]++;
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+    }
+
+    int lookup(const int counts[N][N]) const {
+        return distances.find(encode(counts))->second;
+    }
+
+    size_t size() const {
+        return distances.size();
+    }
+
+private:
+    struct KeyHash {
+        size_t operator()(Key key) const {
+            return mixHash(key);
+        }
+    };
+
+    static Key encode(const int counts[N][N]) {
+        Key key = 0;
+        for (int line = 0; line < N; ++line) {
+            for (int goalLine = 0; goalLine < N; ++goalLine) {
+                key = (key << 3) | (Key)counts[line][goalLine];
+            }
+        }
+        return key;
+    }
+
+    // Returns the blank's line.
+    static int decode(Key key, int counts[N][N]) {
+        int blankLine = 0;
+        for (int line = N - 1; line >= 0; --line) {
+            int sum = 0;
+            for (int goalLine = N - 1; goalLine >= 0; --goalLine) {
+                counts[line][goalLine] = (int)(key & 7);
+                sum += counts[line][goalLine];
+                key >>= 3;
+            }
+            if (sum == N - 1) {
+                blankLine = line;
+            }
+        }
+        return blankLine;
+    }
+
+    std::unordered_map<Key, uint8_t, KeyHash> distances;
+};
+
+// Tables depend only on the goal blank's line, so they are built once per
+// process and shared.
+template <int N>
+const WalkingDistanceTable<N>& walkingDistanceTable(int goalBlankLine) {
+    static std::mutex lock;
+    static std::unique_ptr<WalkingDistanceTable<N>> tables[N];
+    std::lock_guard<std::mutex> guard(lock);
+    if (!tables[goalBlankLine]) {
+        tables[goalBlankLine].reset(new WalkingDistanceTable<N>(goalBlankLine));
+    }
+    return *tables[goalBlankLine];
+}
+
+template <int N>
+void rowCounts(const PackedBoard<N>& board, const GoalTable<N>& goal, int counts[N][N]) {
+    for (int pos = 0; pos < N * N; ++pos) {
+        int tile = board.tileAt(pos);
+        if (tile != 0) {
+            counts[pos / N][goal.goalRow[tile]]++;
+        }
+    }
+}
+
+template <int N>
+void columnCounts(const PackedBoard<N>& board, const GoalTable<N>& goal, int counts[N][N]) {
+    for (int pos = 0; pos < N * N; ++pos) {
+        int tile = board.tileAt(pos);
+        if (tile != 0) {
+            counts[pos % N][goal.goalCol[tile]]++;
+        }
+    }
+}
+
+template <int N>
+int calculateWalkingDistance(const PackedBoard<N>& board, const GoalTable<N>& goal,
+                             const WalkingDistanceTable<N>& rows, const WalkingDistanceTable<N>& columns) {
+    int byRow[N][N] = {};
+    int byColumn[N][N] = {};
+    rowCounts(board, goal, byRow);
+    columnCounts(board, goal, byColumn);
+    return rows.lookup(byRow) + columns.lookup(byColumn);
+}
+
+// A vertical slide only changes the row counts and a horizontal one only the
+// column counts; the matrix before the move differs by the one tile.
+template <int N>
+int walkingDistanceUpdate(const PackedBoard<N>& board, const GoalTable<N>& goal,
+                          const WalkingDistanceTable<N>& rows, const WalkingDistanceTable<N>& columns,
+                          int h, int tile, int from, int to) {
+    int counts[N][N] = {};
+    if (from / N != to / N) {
+        rowCounts(board, goal, counts);
+        int after = rows.lookup(counts);
+        counts[to / N][goal.goalRow[tile]]--;
+        counts[from / N][goal.goalRow[tile]]++;
+        return h - rows.lookup(counts) + after;
+    }
+    columnCounts(board, goal, counts);
+    int after = columns.lookup(counts);
+    counts[to % N][goal.goalCol[tile]]--;
+    counts[from % N][goal.goalCol[tile]]++;
+    return h - columns.lookup(counts) + after;
+}
+
+#endif